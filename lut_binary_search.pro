@@ -1,6 +1,6 @@
-CONFIG += c++11
+CONFIG += c++2a thread
 
 SOURCES += \
     main.cpp
 
-QMAKE_CXXFLAGS_RELEASE += -O3 -g -DNDEBUG
+QMAKE_CXXFLAGS_RELEASE += -O3 -g -DNDEBUG -march=native
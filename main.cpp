@@ -8,213 +8,4010 @@
 #include <random>
 #include <vector>
 #include <chrono>
+#include <span>
+#include <coroutine>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <tuple>
+#include <bit>
+#include <cmath>
 
-// mapping function: specialized for 32-bit signed/unsigned
-// integers and 32-bit floating point values.
-// the mapping functions are used to create the LUT, because signed
-// integers and floats are not comparable using bit-wise comparison.
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// key traits: customization point which makes a key type searchable.
+// a specialization provides
+// - Mapped: unsigned integer type of at most 64 bits
+// - static Mapped Map(T val): order-preserving mapping, i.e. a < b => Map(a) <= Map(b),
+//   which maps equal keys equally, i.e. Equal(a, b) => Map(a) == Map(b)
+// and optionally
+// - static bool Less(T a, T b), static bool Equal(T a, T b): comparisons
+//   (default: the type's operator< and operator==)
+// - static void MapBatch(const T *vals, Mapped *out, size_t n): vectorized Map()
+// - static constexpr bool Injective: whether Equal(a, b) <=> Map(a) == Map(b)
+//   (default: true if the mapping has as many bits as the type)
+// the mapping doesn't need to be one-to-one, e.g. a struct ordered by
+// several fields may be mapped to its first field. but DirectSearchPod,
+// STreePod32, RadixSplinePod32 and SearchTuple (for each field) only
+// compare mapped keys, so they require Equal(a, b) <=> Map(a) == Map(b).
+// SearchPod32's two-level search falls back to binary search for such
+// mappings.
+// the mapping is used to create the LUT, because e.g. signed integers
+// and floats are not comparable using bit-wise comparison.
+template<class T> struct KeyTraits
+{
+};
+
+template<class T> concept MappableKey = requires(T val)
+{
+    { KeyTraits<T>::Map(val) } -> std::same_as<typename KeyTraits<T>::Mapped>;
+    requires std::unsigned_integral<typename KeyTraits<T>::Mapped>;
+};
+
+template<> struct KeyTraits<uint32_t> // 32-bit unsigned int
+{
+    using Mapped = uint32_t;
+
+    static Mapped Map(uint32_t val)
+    {
+        return val; // no bit-twiddling required, just forward
+    }
+};
+
+template<> struct KeyTraits<int32_t> // 32-bit signed int
+{
+    using Mapped = uint32_t;
+
+    static Mapped Map(int32_t val)
+    {
+        return (uint32_t)val^0x80000000; // flip sign bit
+    }
+
+#if defined(__AVX2__)
+    static void MapBatch(const int32_t *vals, Mapped *out, size_t n)
+    {
+        size_t i = 0;
+        for (; i+8<=n; i+=8)
+        {
+            const __m256i v = _mm256_loadu_si256((const __m256i *)(vals+i));
+            _mm256_storeu_si256((__m256i *)(out+i), _mm256_xor_si256(v, _mm256_set1_epi32(0x80000000)));
+        }
+
+        for (; i<n; i++)
+            out[i] = Map(vals[i]);
+    }
+#endif
+};
+
+// taken from Michael Herf's article on Stereopsis
+template<> struct KeyTraits<float> // 32-bit float
+{
+    using Mapped = uint32_t;
+
+    static Mapped Map(float val)
+    {
+        // 1) turn -0 into +0, as they compare equal
+        // 2) flip sign bit
+        // 3) if sign bit was set flip all other bits as well
+        const uint32_t cv = std::bit_cast<uint32_t>(val+0.0f);
+        const uint32_t mask = (-(int32_t)(cv>>31))|0x80000000;
+        return cv^mask;
+    }
+
+#if defined(__AVX2__)
+    static void MapBatch(const float *vals, Mapped *out, size_t n)
+    {
+        size_t i = 0;
+        for (; i+8<=n; i+=8)
+        {
+            // arithmetic shift replicates the sign bit = -(cv>>31)
+            const __m256i v = _mm256_castps_si256(_mm256_add_ps(_mm256_loadu_ps(vals+i), _mm256_setzero_ps()));
+            const __m256i mask = _mm256_or_si256(_mm256_srai_epi32(v, 31), _mm256_set1_epi32(0x80000000));
+            _mm256_storeu_si256((__m256i *)(out+i), _mm256_xor_si256(v, mask));
+        }
+
+        for (; i<n; i++)
+            out[i] = Map(vals[i]);
+    }
+#endif
+};
+
+// IEEE 754 half precision floating point value. it's only stored, not
+// computed with: values are ordered by the IEEE total order, so that
+// equality is the bit-wise one. unlike for floats -0 and +0 are distinct
+// keys, with -0 < +0.
+struct Half
+{
+    uint16_t Bits;
+
+    Half() = default;
+
+    // truncating conversion, denormals are flushed to zero and
+    // out of range values become infinity
+    Half(float val)
+    {
+        const uint32_t cv = std::bit_cast<uint32_t>(val);
+        const uint16_t sign = (cv>>16)&0x8000;
+        const int32_t exp = (int32_t)((cv>>23)&0xff)-127+15;
+
+        if (exp <= 0)
+            Bits = sign;
+        else if (exp >= 31)
+            Bits = sign|0x7c00;
+        else
+            Bits = sign|(exp<<10)|((cv&0x7fffff)>>13);
+    }
+
+    bool operator<(const Half &other) const
+    {
+        return (MapBits() < other.MapBits());
+    }
+
+    bool operator==(const Half &other) const
+    {
+        return (Bits == other.Bits);
+    }
+
+    // like KeyTraits<float>::Map(), but without turning -0 into +0
+    uint16_t MapBits() const
+    {
+        const uint16_t mask = (-(int16_t)(Bits>>15))|0x8000;
+        return Bits^mask;
+    }
+};
+
+template<> struct KeyTraits<uint8_t> // 8-bit unsigned int
+{
+    using Mapped = uint8_t;
+
+    static Mapped Map(uint8_t val)
+    {
+        return val;
+    }
+};
+
+template<> struct KeyTraits<int8_t> // 8-bit signed int
+{
+    using Mapped = uint8_t;
+
+    static Mapped Map(int8_t val)
+    {
+        return (uint8_t)val^0x80; // flip sign bit
+    }
+};
+
+template<> struct KeyTraits<uint16_t> // 16-bit unsigned int
+{
+    using Mapped = uint16_t;
+
+    static Mapped Map(uint16_t val)
+    {
+        return val;
+    }
+};
+
+template<> struct KeyTraits<int16_t> // 16-bit signed int
+{
+    using Mapped = uint16_t;
+
+    static Mapped Map(int16_t val)
+    {
+        return (uint16_t)val^0x8000; // flip sign bit
+    }
+};
+
+template<> struct KeyTraits<Half> // 16-bit float
+{
+    using Mapped = uint16_t;
+
+    static Mapped Map(Half val)
+    {
+        return val.MapBits();
+    }
+};
+
+template<> struct KeyTraits<uint64_t> // 64-bit unsigned int
+{
+    using Mapped = uint64_t;
+
+    static Mapped Map(uint64_t val)
+    {
+        return val;
+    }
+};
+
+template<> struct KeyTraits<int64_t> // 64-bit signed int
+{
+    using Mapped = uint64_t;
+
+    static Mapped Map(int64_t val)
+    {
+        return (uint64_t)val^0x8000000000000000ull; // flip sign bit
+    }
+};
+
+template<> struct KeyTraits<double> // 64-bit float
+{
+    using Mapped = uint64_t;
+
+    static Mapped Map(double val)
+    {
+        // same as for 32-bit floats
+        const uint64_t cv = std::bit_cast<uint64_t>(val+0.0);
+        const uint64_t mask = (-(int64_t)(cv>>63))|0x8000000000000000ull;
+        return cv^mask;
+    }
+};
+
+// durations and time points map like their tick count, so e.g. a
+// std::chrono::time_point with an int32_t duration can be searched
+// with SearchPod32 and the standard clocks' time points with SearchPod64
+template<class REP, class PERIOD> struct KeyTraits<std::chrono::duration<REP, PERIOD>>
+{
+    using Mapped = typename KeyTraits<REP>::Mapped;
+
+    static Mapped Map(std::chrono::duration<REP, PERIOD> val)
+    {
+        return KeyTraits<REP>::Map(val.count());
+    }
+};
+
+template<class CLOCK, class DURATION> struct KeyTraits<std::chrono::time_point<CLOCK, DURATION>>
+{
+    using Mapped = typename KeyTraits<DURATION>::Mapped;
+
+    static Mapped Map(std::chrono::time_point<CLOCK, DURATION> val)
+    {
+        return KeyTraits<DURATION>::Map(val.time_since_epoch());
+    }
+};
+
+// number of bits of the key type's mapping
+template<class T> constexpr size_t MAPPED_KEY_BITS = 8*sizeof(typename KeyTraits<T>::Mapped);
+
+template<class T> constexpr bool IsKeyMappingInjective()
+{
+    if constexpr (requires { KeyTraits<T>::Injective; })
+        return KeyTraits<T>::Injective;
+    else
+        return (MAPPED_KEY_BITS<T> == 8*sizeof(T));
+}
+
+// whether equal mapped keys imply equal keys, so that
+// searches can compare the mapped keys instead of the keys
+template<class T> constexpr bool INJECTIVE_KEY_MAPPING = IsKeyMappingInjective<T>();
+
+// mapping to 32 bits as used by the 32-bit LUTs. narrower mappings
+// are moved into the top bits, so the LUT is indexed by their most
+// significant bits just like for 32-bit types.
 template<class T> uint32_t MapValue(T val)
 {
-    // default implementation results in a compile-time error
-    static_assert(sizeof(T) == 0, "type unavailable: only 32-bit signed/unsigned int and float supported");
-    return 0;
+    static_assert(MappableKey<T>, "type unavailable: specialize KeyTraits for it");
+    static_assert(MAPPED_KEY_BITS<T> <= 32, "type's mapping is wider than 32 bits");
+    return (uint32_t)KeyTraits<T>::Map(val)<<(32-MAPPED_KEY_BITS<T>);
+}
+
+// same for the 64-bit LUTs
+template<class T> uint64_t MapValue64(T val)
+{
+    static_assert(MappableKey<T>, "type unavailable: specialize KeyTraits for it");
+    return (uint64_t)KeyTraits<T>::Map(val)<<(64-MAPPED_KEY_BITS<T>);
+}
+
+// maps n values with MapValue(), vectorized if the traits support it
+template<class T> void MapValues(const T *vals, uint32_t *out, size_t n)
+{
+    if constexpr (requires { KeyTraits<T>::MapBatch(vals, out, n); })
+        KeyTraits<T>::MapBatch(vals, out, n);
+    else
+    {
+        for (size_t i=0; i<n; i++)
+            out[i] = MapValue<T>(vals[i]);
+    }
+}
+
+// comparisons of the traits if available, otherwise of the type
+template<class T> bool KeyLess(T a, T b)
+{
+    if constexpr (requires { KeyTraits<T>::Less(a, b); })
+        return KeyTraits<T>::Less(a, b);
+    else
+        return a < b;
+}
+
+template<class T> bool KeyEqual(T a, T b)
+{
+    if constexpr (requires { KeyTraits<T>::Equal(a, b); })
+        return KeyTraits<T>::Equal(a, b);
+    else
+        return a == b;
+}
+
+// std::lower_bound() baseline, using the key's comparisons
+template<class T> ssize_t StdBinarySearch(const std::vector<T> &vals, T key)
+{
+    const auto iter = std::lower_bound(vals.begin(), vals.end(), key, [](T a, T b)
+    {
+        return KeyLess(a, b);
+    });
+    return (iter != vals.end() && KeyEqual(*iter, key) ? std::distance(vals.begin(), iter) : -1);
+}
+
+// binary search for the first occurence of the key in vals[left] ... vals[right]
+template<class T> ssize_t BinarySearch(const std::vector<T> &vals, ssize_t left, ssize_t right, T key)
+{
+    /*
+    size_t __len = right-left;
+    size_t __first = left;
+
+    while (__len > 0)
+    {
+        size_t __half = __len >> 1;
+        size_t __middle = __first+__half;
+
+        if (vals[__middle] < key)
+        {
+            __first = __middle;
+            ++__first;
+
+            __len = __len - __half - 1;
+        }
+        else
+            __len = __half;
+    }
+
+    return __first;
+    */
+
+    while (left < right)
+    {
+        const auto mid = left+((right-left)>>1); // avoids overflow
+        assert(mid < right); // interval must be reduced in each iteration
+        const auto valMid = vals[mid];
+
+        // no early exit so that always the occurence
+        // of the key with the lowest index is found
+        if (KeyLess(valMid, key))
+            left = mid+1;
+        else
+            right = mid;
+    }
+
+    assert(left == right || left == right+1); // empty LUT intervals end before they start
+    return (KeyEqual(vals[left], key) ? left : -1);
+}
+
+// same lower-bound semantics as BinarySearch(), but the loop only
+// depends on the interval length: the number of iterations is
+// ceil(log2(len)) and the comparison result feeds a conditional
+// move instead of a branch, so there are no mispredictions
+template<class T> ssize_t BranchlessSearch(const std::vector<T> &vals, ssize_t left, ssize_t right, T key)
+{
+    const T *data = vals.data();
+    size_t len = (right > left ? right-left+1 : 1); // empty interval => only check left
+
+    while (len > 1)
+    {
+        const size_t half = len>>1;
+        left += (KeyLess(data[left+half-1], key) ? half : 0);
+        len -= half;
+    }
+
+    return (KeyEqual(data[left], key) ? left : -1);
+}
+
+// index of the first value in vals[left] ... vals[right] which isn't
+// smaller than the key, right+1 if there's none
+template<class T> size_t LowerBound(const std::vector<T> &vals, ssize_t left, ssize_t right, T key)
+{
+    if (left > right)
+        return left;
+
+    while (left < right)
+    {
+        const auto mid = left+((right-left)>>1);
+        if (KeyLess(vals[mid], key))
+            left = mid+1;
+        else
+            right = mid;
+    }
+
+    return (KeyLess(vals[left], key) ? left+1 : left);
+}
+
+// index of the first value in vals[left] ... vals[right] which is
+// bigger than the key, right+1 if there's none
+template<class T> size_t UpperBound(const std::vector<T> &vals, ssize_t left, ssize_t right, T key)
+{
+    if (left > right)
+        return left;
+
+    while (left < right)
+    {
+        const auto mid = left+((right-left)>>1);
+        if (!KeyLess(key, vals[mid]))
+            left = mid+1;
+        else
+            right = mid;
+    }
+
+    return (!KeyLess(key, vals[left]) ? left+1 : left);
+}
+
+// counts how many of the first n sorted values are smaller than the
+// key, i.e. a linear lower bound. vectorized for all supported types,
+// so short intervals can be scanned with hardly any branch misses.
+template<class T> size_t SimdCountLess(const T *vals, size_t n, T key)
+{
+    size_t i = 0;
+    while (i < n && KeyLess(vals[i], key))
+        i++;
+    return i;
+}
+
+#if defined(__AVX2__)
+// 8 lanes at a time; stops at the first chunk containing a value >= key
+template<class T, class CMP_FUNC> size_t SimdCountLess8(const T *vals, size_t n, T key, const CMP_FUNC &cmpFunc)
+{
+    size_t i = 0;
+
+    for (; i+8<=n; i+=8)
+    {
+        const uint32_t mask = (uint32_t)_mm256_movemask_ps(cmpFunc(vals+i));
+        if (mask != 0xff)
+            return i+__builtin_popcount(mask);
+    }
+
+    // remaining values
+    while (i < n && KeyLess(vals[i], key))
+        i++;
+    return i;
+}
+
+template<> size_t SimdCountLess<int32_t>(const int32_t *vals, size_t n, int32_t key)
+{
+    const __m256i keys = _mm256_set1_epi32(key);
+    return SimdCountLess8(vals, n, key, [&](const int32_t *p)
+    {
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(keys, _mm256_loadu_si256((const __m256i *)p)));
+    });
+}
+
+template<> size_t SimdCountLess<uint32_t>(const uint32_t *vals, size_t n, uint32_t key)
+{
+    // no unsigned compare in AVX2 => flip sign bits and compare signed
+    const __m256i signBits = _mm256_set1_epi32((int32_t)0x80000000);
+    const __m256i keys = _mm256_set1_epi32((int32_t)(key^0x80000000));
+    return SimdCountLess8(vals, n, key, [&](const uint32_t *p)
+    {
+        const __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)p), signBits);
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(keys, v));
+    });
+}
+
+template<> size_t SimdCountLess<float>(const float *vals, size_t n, float key)
+{
+    const __m256 keys = _mm256_set1_ps(key);
+    return SimdCountLess8(vals, n, key, [&](const float *p)
+    {
+        return _mm256_cmp_ps(_mm256_loadu_ps(p), keys, _CMP_LT_OQ);
+    });
+}
+#endif
+
+// aggregates over a span of values, e.g. the result of SearchPod32::Scan().
+// sums are accumulated in 64-bit integers or doubles, so they don't
+// overflow. vectorized for 32-bit types.
+template<class T> using ScanSumType = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+template<class T> ScanSumType<T> ScanSum(std::span<const T> vals)
+{
+    ScanSumType<T> sum = 0;
+    for (const auto &v : vals)
+        sum += v;
+    return sum;
+}
+
+// smallest and biggest value of a non-empty span
+template<class T> std::pair<T, T> ScanMinMax(std::span<const T> vals)
+{
+    assert(!vals.empty());
+    std::pair<T, T> minMax(vals[0], vals[0]);
+    for (const auto &v : vals)
+    {
+        minMax.first = std::min(minMax.first, v);
+        minMax.second = std::max(minMax.second, v);
+    }
+
+    return minMax;
+}
+
+// number of values the predicate holds for. branch-free, so that the
+// compiler can vectorize simple predicates.
+template<class T, class PRED> size_t ScanCountIf(std::span<const T> vals, const PRED &pred)
+{
+    size_t count = 0;
+    for (const auto &v : vals)
+        count += (pred(v) ? 1 : 0);
+    return count;
+}
+
+// copies the values the predicate holds for to out, which must be big
+// enough for all values. returns the number of copied values. the
+// value is always written and the position only advanced if the
+// predicate holds, so there are no branch misses for random predicates.
+template<class T, class PRED> size_t ScanFilter(std::span<const T> vals, std::span<T> out, const PRED &pred)
+{
+    assert(out.size() >= vals.size());
+    size_t num = 0;
+    for (const auto &v : vals)
+    {
+        out[num] = v;
+        num += (pred(v) ? 1 : 0);
+    }
+
+    return num;
+}
+
+#if defined(__AVX2__)
+// 8 lanes at a time: addFunc() adds the 8 values at p to the accumulator
+template<class T, class ACC, class ADD_FUNC> ACC ScanSum8(std::span<const T> vals, ACC acc, const ADD_FUNC &addFunc, ScanSumType<T> &tail)
+{
+    size_t i = 0;
+    for (; i+8<=vals.size(); i+=8)
+        acc = addFunc(acc, vals.data()+i);
+
+    // remaining values
+    tail = 0;
+    for (; i<vals.size(); i++)
+        tail += vals[i];
+
+    return acc;
+}
+
+template<> ScanSumType<int32_t> ScanSum<int32_t>(std::span<const int32_t> vals)
+{
+    int64_t sum;
+    const __m256i acc = ScanSum8(vals, _mm256_setzero_si256(), [](__m256i acc, const int32_t *p)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }, sum);
+
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256((__m256i *)lanes, acc);
+    return sum+lanes[0]+lanes[1]+lanes[2]+lanes[3];
+}
+
+template<> ScanSumType<uint32_t> ScanSum<uint32_t>(std::span<const uint32_t> vals)
+{
+    uint64_t sum;
+    const __m256i acc = ScanSum8(vals, _mm256_setzero_si256(), [](__m256i acc, const uint32_t *p)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+        return _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+    }, sum);
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256((__m256i *)lanes, acc);
+    return sum+lanes[0]+lanes[1]+lanes[2]+lanes[3];
+}
+
+template<> ScanSumType<float> ScanSum<float>(std::span<const float> vals)
+{
+    double sum;
+    const __m256d acc = ScanSum8(vals, _mm256_setzero_pd(), [](__m256d acc, const float *p)
+    {
+        acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm_loadu_ps(p)));
+        return _mm256_add_pd(acc, _mm256_cvtps_pd(_mm_loadu_ps(p+4)));
+    }, sum);
+
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return sum+lanes[0]+lanes[1]+lanes[2]+lanes[3];
+}
+
+// 8 lanes at a time: the min and max functions combine 8 values
+template<class T, class VEC, class LOAD_FUNC, class MIN_FUNC, class MAX_FUNC> std::pair<T, T> ScanMinMax8(std::span<const T> vals, const LOAD_FUNC &loadFunc, const MIN_FUNC &minFunc, const MAX_FUNC &maxFunc)
+{
+    assert(!vals.empty());
+    if (vals.size() < 8)
+    {
+        std::pair<T, T> minMax(vals[0], vals[0]);
+        for (const auto &v : vals)
+        {
+            minMax.first = std::min(minMax.first, v);
+            minMax.second = std::max(minMax.second, v);
+        }
+
+        return minMax;
+    }
+
+    // the last chunk overlaps the previous one instead of a scalar tail
+    VEC mins = loadFunc(vals.data()), maxs = mins;
+    for (size_t i=8; i<vals.size(); i+=8)
+    {
+        const VEC v = loadFunc(vals.data()+std::min(i, vals.size()-8));
+        mins = minFunc(mins, v);
+        maxs = maxFunc(maxs, v);
+    }
+
+    alignas(32) T minLanes[8], maxLanes[8];
+    std::memcpy(minLanes, &mins, sizeof(mins));
+    std::memcpy(maxLanes, &maxs, sizeof(maxs));
+    return std::make_pair(*std::min_element(minLanes, minLanes+8), *std::max_element(maxLanes, maxLanes+8));
+}
+
+template<> std::pair<int32_t, int32_t> ScanMinMax<int32_t>(std::span<const int32_t> vals)
+{
+    return ScanMinMax8<int32_t, __m256i>(vals, [](const int32_t *p) {return _mm256_loadu_si256((const __m256i *)p);},
+        [](__m256i a, __m256i b) {return _mm256_min_epi32(a, b);}, [](__m256i a, __m256i b) {return _mm256_max_epi32(a, b);});
+}
+
+template<> std::pair<uint32_t, uint32_t> ScanMinMax<uint32_t>(std::span<const uint32_t> vals)
+{
+    return ScanMinMax8<uint32_t, __m256i>(vals, [](const uint32_t *p) {return _mm256_loadu_si256((const __m256i *)p);},
+        [](__m256i a, __m256i b) {return _mm256_min_epu32(a, b);}, [](__m256i a, __m256i b) {return _mm256_max_epu32(a, b);});
+}
+
+template<> std::pair<float, float> ScanMinMax<float>(std::span<const float> vals)
+{
+    return ScanMinMax8<float, __m256>(vals, [](const float *p) {return _mm256_loadu_ps(p);},
+        [](__m256 a, __m256 b) {return _mm256_min_ps(a, b);}, [](__m256 a, __m256 b) {return _mm256_max_ps(a, b);});
+}
+#endif
+
+// coroutine computing a single search result. searches suspend right
+// after prefetching the memory they access next, so that a scheduler
+// can resume other searches until the data arrived in cache (see
+// RunInterleaved()). coroutine frames are recycled per thread to keep
+// heap allocations out of the search loop.
+class SearchTask
+{
+public:
+    struct promise_type
+    {
+        SearchTask get_return_object()
+        {
+            return SearchTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(ssize_t res) { Result = res; }
+        void unhandled_exception() { std::terminate(); }
+
+        static void * operator new(size_t size)
+        {
+            auto &cache = FrameCache();
+            if (!cache.empty() && cache.back().second == size)
+            {
+                void *frame = cache.back().first;
+                cache.pop_back();
+                return frame;
+            }
+
+            return ::operator new(size);
+        }
+
+        static void operator delete(void *frame, size_t size)
+        {
+            auto &cache = FrameCache();
+            if (cache.size() < 1024)
+                cache.push_back(std::make_pair(frame, size));
+            else
+                ::operator delete(frame);
+        }
+
+        ssize_t Result = -1;
+    };
+
+    SearchTask() = default;
+
+    SearchTask(SearchTask &&other) noexcept :
+        Handle(std::exchange(other.Handle, nullptr))
+    {
+    }
+
+    SearchTask & operator = (SearchTask &&other) noexcept
+    {
+        std::swap(Handle, other.Handle);
+        return *this;
+    }
+
+    ~SearchTask()
+    {
+        if (Handle)
+            Handle.destroy();
+    }
+
+    bool Valid() const
+    {
+        return (bool)Handle;
+    }
+
+    // resumes the search until its next suspension point; returns true
+    // if the search finished
+    bool Resume()
+    {
+        Handle.resume();
+        return Handle.done();
+    }
+
+    ssize_t Result() const
+    {
+        return Handle.promise().Result;
+    }
+
+private:
+    explicit SearchTask(std::coroutine_handle<promise_type> handle) :
+        Handle(handle)
+    {
+    }
+
+    struct FrameList : public std::vector<std::pair<void *, size_t>>
+    {
+        ~FrameList()
+        {
+            for (const auto &frame : *this)
+                ::operator delete(frame.first);
+        }
+    };
+
+    static FrameList & FrameCache()
+    {
+        static thread_local FrameList cache;
+        return cache;
+    }
+
+private:
+    std::coroutine_handle<promise_type> Handle;
+};
+
+// resolves all keys with coroutine searches created by taskFunc(key),
+// keeping numInFlight searches alive and resuming them round-robin
+template<class T, class TASK_FUNC> void RunInterleaved(std::span<const T> keys, std::span<ssize_t> out, size_t numInFlight, const TASK_FUNC &taskFunc)
+{
+    assert(keys.size() == out.size());
+    assert(numInFlight > 0);
+
+    std::vector<SearchTask> tasks(std::min(numInFlight, keys.size()));
+    std::vector<size_t> taskKeys(tasks.size());
+    size_t nextKey = 0;
+
+    for (size_t i=0; i<tasks.size(); i++, nextKey++)
+    {
+        tasks[i] = taskFunc(keys[nextKey]);
+        taskKeys[i] = nextKey;
+    }
+
+    for (size_t numActive=tasks.size(); numActive>0; )
+    {
+        for (size_t i=0; i<tasks.size(); i++)
+        {
+            if (!tasks[i].Valid() || !tasks[i].Resume())
+                continue;
+
+            out[taskKeys[i]] = tasks[i].Result();
+
+            if (nextKey < keys.size())
+            {
+                tasks[i] = taskFunc(keys[nextKey]);
+                taskKeys[i] = nextKey++;
+            }
+            else
+            {
+                tasks[i] = SearchTask();
+                numActive--;
+            }
+        }
+    }
+}
+
+// thread pool for fork-join parallel loops. the tasks of a loop are
+// distributed over per-worker queues in contiguous blocks; workers take
+// tasks from the front of their own queue and steal from the back of
+// the other ones' queues once theirs ran empty, so that workers getting
+// the expensive tasks don't leave the others idle.
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(size_t numThreads)
+    {
+        assert(numThreads > 0);
+
+        for (size_t i=0; i<numThreads; i++)
+            Workers.push_back(std::unique_ptr<Worker>(new Worker));
+        for (size_t i=0; i<numThreads; i++)
+            Threads.push_back(std::thread(&WorkStealingPool::WorkerLoop, this, i));
+
+        // wait until all workers stored their thread id
+        std::unique_lock<std::mutex> lock(JobMutex);
+        DoneCv.wait(lock, [this]{ return NumStarted == Workers.size(); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(JobMutex);
+            Quit = true;
+        }
+
+        JobCv.notify_all();
+        for (auto &t : Threads)
+            t.join();
+    }
+
+    size_t NumThreads() const
+    {
+        return Threads.size();
+    }
+
+    // OS thread ids of the workers, e.g. to count their cache misses.
+    // empty if they aren't available on this platform.
+    std::vector<int> ThreadIds() const
+    {
+        std::vector<int> ids;
+#if defined(__linux__)
+        for (const auto &w : Workers)
+            ids.push_back(w->ThreadId);
+#endif
+        return ids;
+    }
+
+    // calls func(i) for all i in [0, numTasks) and returns when all calls finished
+    void ParallelFor(size_t numTasks, const std::function<void(size_t)> &func)
+    {
+        if (numTasks == 0)
+            return;
+
+        std::unique_lock<std::mutex> lock(JobMutex);
+        JobFunc = func;
+        Pending = numTasks;
+
+        for (size_t i=0; i<Workers.size(); i++)
+        {
+            std::lock_guard<std::mutex> workerLock(Workers[i]->Mutex);
+            for (size_t j=numTasks*i/Workers.size(); j<numTasks*(i+1)/Workers.size(); j++)
+                Workers[i]->Tasks.push_back(j);
+        }
+
+        JobId++;
+        JobCv.notify_all();
+        DoneCv.wait(lock, [this]{ return Pending == 0; });
+    }
+
+private:
+    struct Worker
+    {
+        std::mutex         Mutex;
+        std::deque<size_t> Tasks;
+        int                ThreadId = -1;
+    };
+
+    bool PopOrSteal(size_t self, size_t &task)
+    {
+        for (size_t i=0; i<Workers.size(); i++)
+        {
+            Worker &w = *Workers[(self+i)%Workers.size()];
+            std::lock_guard<std::mutex> lock(w.Mutex);
+
+            if (!w.Tasks.empty())
+            {
+                if (i == 0) // own queue
+                {
+                    task = w.Tasks.front();
+                    w.Tasks.pop_front();
+                }
+                else
+                {
+                    task = w.Tasks.back();
+                    w.Tasks.pop_back();
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkerLoop(size_t self)
+    {
+        size_t seenJobId = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(JobMutex);
+#if defined(__linux__)
+            Workers[self]->ThreadId = (int)syscall(SYS_gettid);
+#endif
+            NumStarted++;
+        }
+
+        DoneCv.notify_all();
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(JobMutex);
+                JobCv.wait(lock, [&]{ return Quit || JobId != seenJobId; });
+                if (Quit)
+                    return;
+                seenJobId = JobId;
+            }
+
+            size_t task;
+            while (PopOrSteal(self, task))
+            {
+                JobFunc(task);
+
+                if (--Pending == 0)
+                {
+                    std::lock_guard<std::mutex> lock(JobMutex);
+                    DoneCv.notify_all();
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Worker>> Workers;
+    std::vector<std::thread>             Threads;
+    std::mutex                           JobMutex;
+    std::condition_variable              JobCv;
+    std::condition_variable              DoneCv;
+    std::function<void(size_t)>          JobFunc;
+    std::atomic<size_t>                  Pending{0};
+    size_t                               JobId = 0;
+    size_t                               NumStarted = 0;
+    bool                                 Quit = false;
+};
+
+// splits the keys into chunks which are resolved in parallel by
+// batchFunc(keys, out). results are written in input order.
+template<class T, class BATCH_FUNC> void ParallelBatchSearch(WorkStealingPool &pool, std::span<const T> keys, std::span<ssize_t> out, size_t chunkSize, const BATCH_FUNC &batchFunc)
+{
+    assert(keys.size() == out.size());
+    assert(chunkSize > 0);
+
+    pool.ParallelFor((keys.size()+chunkSize-1)/chunkSize, [&](size_t chunk)
+    {
+        const size_t first = chunk*chunkSize;
+        const size_t num = std::min(chunkSize, keys.size()-first);
+        batchFunc(keys.subspan(first, num), out.subspan(first, num));
+    });
+}
+
+// fills a LUT with lutSize entries for numVals sorted values, where
+// indexFunc(i) returns the LUT index of the i-th value. entry j is the
+// index of the first value with a LUT index >= j. lutEnd is set to the
+// last value's LUT index, because the interval end of all entries from
+// there on is the last value and not the next entry.
+template<class INDEX_FUNC> std::vector<size_t> BuildLut(size_t numVals, size_t lutSize, size_t &lutEnd, const INDEX_FUNC &indexFunc)
+{
+    std::vector<size_t> lut(lutSize);
+
+    // all entries up to the first value's threshold start at index 0
+    size_t thresh = indexFunc(0);
+    size_t last = 0;
+
+    for (ssize_t i=0; i<(ssize_t)numVals-1; i++)
+    {
+        const size_t nextThresh = indexFunc(i+1);
+        lut[thresh] = last;
+
+        if (nextThresh > thresh)
+        {
+            last = i+1;
+            for (size_t j=thresh+1; j<=nextThresh; j++)
+                lut[j] = last;
+        }
+
+        thresh = nextThresh;
+    }
+
+    // set remaining thresholds that couldn't be found
+    for (size_t i=thresh; i<lut.size(); i++)
+        lut[i] = last;
+
+    lutEnd = thresh;
+    return lut;
+}
+
+// LUT storage with plain entries. 32-bit entries halve the LUT size
+// compared to size_t entries and can be used if there are less than
+// 2^32 values.
+template<class ENTRY> class PlainLut
+{
+public:
+    void Build(std::vector<size_t> entries)
+    {
+        assert(entries.back() <= std::numeric_limits<ENTRY>::max());
+
+        if constexpr (std::is_same<ENTRY, size_t>::value)
+            Entries = std::move(entries);
+        else
+            Entries.assign(entries.begin(), entries.end());
+    }
+
+    size_t operator [] (size_t i) const
+    {
+        return Entries[i];
+    }
+
+    void Prefetch(size_t i) const
+    {
+        __builtin_prefetch(&Entries[i]);
+    }
+
+    size_t MemoryFootprint() const
+    {
+        return Entries.size()*sizeof(ENTRY);
+    }
+
+private:
+    std::vector<ENTRY> Entries;
+};
+
+// LUT storage as Elias-Fano encoded monotone sequence: each entry is
+// split into its low bits, stored verbatim in a packed array, and its
+// high bits, stored as unary coded gaps in a bit vector. this takes
+// about 2+log2(numValues/numEntries) bits per entry. to access an entry
+// in constant time, the position of every SELECT_SAMPLE-th one in the
+// bit vector is sampled, so that only a few words have to be scanned.
+// skewed data, e.g. a LUT entry holding half of the values, leaves long
+// runs of zeros, which would have to be scanned as well. therefore the
+// one-positions of blocks spanning more than SPARSE_SPAN_BITS bits are
+// stored explicitly, like in the darray of Okanohara and Sadakane.
+class EliasFanoLut
+{
+public:
+    void Build(const std::vector<size_t> &entries)
+    {
+        NumEntries = entries.size();
+        const size_t universe = entries.back()+1;
+        LowBits = 0;
+        while (((size_t)2<<LowBits) <= universe/NumEntries)
+            LowBits++;
+
+        const size_t numHighBits = NumEntries+(universe>>LowBits)+1;
+        High.assign((numHighBits+63)/64, 0);
+        Low.assign((NumEntries*LowBits+63)/64+1, 0); // +1 => unaligned reads never leave the array
+        Samples.clear();
+        SparsePositions.clear();
+
+        for (size_t i=0; i<NumEntries; i++)
+        {
+            const size_t highPos = (entries[i]>>LowBits)+i;
+            High[highPos/64] |= (uint64_t)1<<(highPos%64);
+            if (i%SELECT_SAMPLE == 0)
+                Samples.push_back(highPos);
+
+            if (LowBits > 0)
+            {
+                const uint64_t low = entries[i]&(((uint64_t)1<<LowBits)-1);
+                const size_t lowPos = i*LowBits;
+                Low[lowPos/64] |= low<<(lowPos%64);
+                if (lowPos%64+LowBits > 64)
+                    Low[lowPos/64+1] |= low>>(64-lowPos%64);
+            }
+        }
+
+        for (size_t first=0; first<NumEntries; first+=SELECT_SAMPLE)
+        {
+            const size_t last = std::min(first+SELECT_SAMPLE, NumEntries)-1;
+            const size_t firstPos = (entries[first]>>LowBits)+first;
+            if ((entries[last]>>LowBits)+last-firstPos > SPARSE_SPAN_BITS)
+            {
+                Samples[first/SELECT_SAMPLE] = SPARSE_BLOCK|SparsePositions.size();
+                for (size_t i=first; i<=last; i++)
+                    SparsePositions.push_back((entries[i]>>LowBits)+i);
+            }
+        }
+    }
+
+    size_t operator [] (size_t i) const
+    {
+        const size_t sample = Samples[i/SELECT_SAMPLE];
+        size_t rank = i%SELECT_SAMPLE;
+        if (sample&SPARSE_BLOCK)
+            return ((SparsePositions[(sample&~SPARSE_BLOCK)+rank]-i)<<LowBits)|GetLow(i);
+
+        // skip the ones preceding the i-th one, starting from the sample.
+        // they're at most SPARSE_SPAN_BITS bits behind it.
+        size_t word = sample/64;
+        uint64_t bits = High[word]&(~(uint64_t)0<<(sample%64));
+
+        while (true)
+        {
+            const size_t ones = __builtin_popcountll(bits);
+            if (rank < ones)
+                break;
+
+            rank -= ones;
+            bits = High[++word];
+        }
+
+        const size_t highPos = word*64+SelectInWord(bits, rank);
+        return ((highPos-i)<<LowBits)|GetLow(i);
+    }
+
+    void Prefetch(size_t i) const
+    {
+        __builtin_prefetch(&Samples[i/SELECT_SAMPLE]);
+        __builtin_prefetch(&Low[i*LowBits/64]);
+    }
+
+    size_t MemoryFootprint() const
+    {
+        return (High.size()+Low.size())*sizeof(uint64_t)+(Samples.size()+SparsePositions.size())*sizeof(size_t);
+    }
+
+private:
+    static const size_t SELECT_SAMPLE = 64;
+    static const size_t SPARSE_SPAN_BITS = 32*64; // => explicit positions take at most 2 bits per bit of High
+    static const size_t SPARSE_BLOCK = (size_t)1<<63; // flags samples which index SparsePositions
+
+    size_t GetLow(size_t i) const
+    {
+        if (LowBits == 0)
+            return 0;
+
+        const size_t lowPos = i*LowBits;
+        const uint64_t lo = Low[lowPos/64]>>(lowPos%64);
+        const uint64_t hi = (lowPos%64 == 0 ? 0 : Low[lowPos/64+1]<<(64-lowPos%64));
+        return (lo|hi)&(((uint64_t)1<<LowBits)-1);
+    }
+
+    // position of the rank-th one in the word
+    static size_t SelectInWord(uint64_t bits, size_t rank)
+    {
+#if defined(__BMI2__)
+        return __builtin_ctzll(_pdep_u64((uint64_t)1<<rank, bits));
+#else
+        for (size_t i=0; i<rank; i++)
+            bits &= bits-1;
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+private:
+    std::vector<uint64_t> High;
+    std::vector<uint64_t> Low;
+    std::vector<size_t>   Samples;
+    std::vector<size_t>   SparsePositions;
+    size_t                NumEntries;
+    size_t                LowBits;
+};
+
+// how mapped keys are turned into LUT indices. it's a template parameter
+// of SearchPod32, so that TopBits stays a single shift without range check.
+enum class LutMapping
+{
+    TopBits,      // top LUT bits of the mapped key
+    CommonPrefix, // top LUT bits after the prefix common to all values
+    Range         // (mappedKey-min)*scale, so that the LUT spans [min, max]
+};
+
+// LUT optimized binary search implementation for 32-bit POD types
+template<class T, size_t LUT_BITS, class LUT=PlainLut<size_t>, LutMapping MAPPING=LutMapping::TopBits> class SearchPod32
+{
+public:
+    SearchPod32(const std::vector<T> &vals, size_t maxIntervalSize=256, size_t skewFactor=DEFAULT_SKEW_FACTOR) :
+        Vals(vals),
+        ScanThresh(DEFAULT_SCAN_THRESHOLD),
+        MaxIntervalSize(maxIntervalSize),
+        SkewFactor(skewFactor)
+    {
+        static_assert(LUT_BITS > 0 && LUT_BITS < 32, "invalid binary search LUT size");
+        static_assert(MAPPED_KEY_BITS<T> <= 32, "type's mapping is wider than 32 bits: use SearchPod64");
+        static_assert(LUT_BITS < MAPPED_KEY_BITS<T> || !INJECTIVE_KEY_MAPPING<T>, "LUT covers the whole key space: use DirectSearchPod");
+        InitLutMapping();
+        InitLut();
+        InitSubLuts();
+    }
+
+    ssize_t StdBinarySearch(T key) const
+    {
+        return ::StdBinarySearch(Vals, key);
+    }
+
+    ssize_t MyBinarySearch(T key) const
+    {
+        return BinarySearch(0, (ssize_t)Vals.size()-1, key);
+    }
+
+    ssize_t LutBinarySearch(T key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end))
+            return -1;
+        return BinarySearch(start, end, key);
+    }
+
+    ssize_t LutBranchlessSearch(T key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end))
+            return -1;
+        return BranchlessSearch(start, end, key);
+    }
+
+    // searches all keys, processing groups of groupSize keys interleaved:
+    // each step of the (branchless) search is done for all keys of the
+    // group, while prefetching the LUT entries and the values probed
+    // next. so up to groupSize cache misses are in flight at a time.
+    void LutBinarySearchBatch(std::span<const T> keys, std::span<ssize_t> out, size_t groupSize=16) const
+    {
+        assert(keys.size() == out.size());
+        assert(groupSize > 0 && groupSize <= MAX_BATCH_GROUP);
+
+        for (size_t first=0; first<keys.size(); first+=groupSize)
+        {
+            const size_t num = std::min(groupSize, keys.size()-first);
+            const T *groupKeys = &keys[first];
+            size_t lutIdxs[MAX_BATCH_GROUP];
+            ssize_t lefts[MAX_BATCH_GROUP];
+            size_t lens[MAX_BATCH_GROUP];
+            size_t maxLen = 0;
+
+            uint32_t mappedKeys[MAX_BATCH_GROUP];
+            MapValues(groupKeys, mappedKeys, num);
+
+            for (size_t i=0; i<num; i++)
+            {
+                lutIdxs[i] = MappedLutIndex(mappedKeys[i]);
+                Lut.Prefetch(lutIdxs[i]);
+            }
+
+            for (size_t i=0; i<num; i++)
+            {
+                ssize_t end;
+                LutIntervalAt(lutIdxs[i], lefts[i], end);
+                lens[i] = (end > lefts[i] ? end-lefts[i]+1 : 1);
+                maxLen = std::max(maxLen, lens[i]);
+                __builtin_prefetch(&Vals[lefts[i]+(lens[i]>>1)-(lens[i] > 1)]);
+            }
+
+            // same steps as BranchlessSearch(), one per key and round
+            for (; maxLen>1; maxLen-=(maxLen>>1))
+            {
+                for (size_t i=0; i<num; i++)
+                {
+                    if (lens[i] > 1)
+                    {
+                        const size_t half = lens[i]>>1;
+                        lefts[i] += (KeyLess(Vals[lefts[i]+half-1], groupKeys[i]) ? half : 0);
+                        lens[i] -= half;
+                        __builtin_prefetch(&Vals[lefts[i]+(lens[i]>>1)-(lens[i] > 1)]);
+                    }
+                }
+            }
+
+            for (size_t i=0; i<num; i++)
+                out[first+i] = (KeyEqual(Vals[lefts[i]], groupKeys[i]) ? lefts[i] : -1);
+        }
+    }
+
+    // batch search for keys in ascending order, e.g. coming out of a merge
+    // join. the lower bound of a key is at or after the previous key's one,
+    // so each search gallops forward from the previous result. the LUT is
+    // only read when a key falls into another LUT interval than its
+    // predecessor, to skip the values in between. unsorted batches fall
+    // back to LutBinarySearchBatch().
+    void LutSortedBatchSearch(std::span<const T> keys, std::span<ssize_t> out, bool keysSorted=false) const
+    {
+        assert(keys.size() == out.size());
+
+        const auto keyLess = [](T a, T b)
+        {
+            return KeyLess(a, b);
+        };
+
+        if (!keysSorted && !std::is_sorted(keys.begin(), keys.end(), keyLess))
+        {
+            LutBinarySearchBatch(keys, out);
+            return;
+        }
+
+        ssize_t pos = 0, end = -1;
+        size_t lutIdx = std::numeric_limits<size_t>::max();
+
+        for (size_t i=0; i<keys.size(); i++)
+        {
+            const size_t keyLutIdx = LutIndex(keys[i]);
+
+            if (keyLutIdx != lutIdx)
+            {
+                ssize_t start;
+                LutIntervalAt(keyLutIdx, start, end);
+                pos = std::max(pos, start);
+                lutIdx = keyLutIdx;
+            }
+
+            out[i] = (pos <= end ? GallopSearch(pos, end, pos, keys[i]) : -1);
+            pos = std::max(pos, out[i]);
+        }
+    }
+
+    // BinarySearch() on the key's LUT interval as coroutine which suspends
+    // after prefetching the LUT entry and each probed value
+    SearchTask LutBinarySearchTask(T key) const
+    {
+        const size_t lutIdx = LutIndex(key);
+        Lut.Prefetch(lutIdx);
+        co_await std::suspend_always();
+
+        ssize_t left, right;
+        LutIntervalAt(lutIdx, left, right);
+
+        while (left < right)
+        {
+            const auto mid = left+((right-left)>>1);
+            __builtin_prefetch(&Vals[mid]);
+            co_await std::suspend_always();
+
+            if (KeyLess(Vals[mid], key))
+                left = mid+1;
+            else
+                right = mid;
+        }
+
+        co_return (KeyEqual(Vals[left], key) ? left : -1);
+    }
+
+    // linear SIMD scan for small LUT intervals, binary search for large ones
+    ssize_t LutHybridSearch(T key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end))
+            return -1;
+        return (end-start < (ssize_t)ScanThresh ? ScanSearch(start, end, key) : BinarySearch(start, end, key));
+    }
+
+    // predicts the position inside the LUT interval from the key's position
+    // inside the LUT entry and searches outwards from there. for
+    // uniformly distributed values the prediction is off by only a few
+    // values; if it overshoots, the galloping search bounds the number of
+    // probes to 2*log2(interval length).
+    ssize_t LutInterpolationSearch(T key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end) || end < start)
+            return -1;
+
+        const uint64_t keyFrac = (uint32_t)LutPosition(MapValue<T>(key)); // key position in LUT entry's key range as 0.32 fixed point
+        const ssize_t guess = start+(ssize_t)((keyFrac*(uint64_t)(end-start+1))>>32);
+        return GallopSearch(start, end, guess, key);
+    }
+
+    // skewed LUT intervals, i.e. ones with more than maxIntervalSize values
+    // and skewFactor times the average number of values, are
+    // subdivided by a second-level LUT on the key's position inside the
+    // LUT entry, and its intervals with more than maxIntervalSize values
+    // recursively by further sub-LUTs. this bounds the search also for
+    // clustered data, where most values fall into a few LUT intervals,
+    // while uniformly distributed data doesn't get any sub-LUTs. a
+    // skewFactor of 0 splits all intervals with more than maxIntervalSize
+    // values, which bounds the search for any data. runs of
+    // copies of one value can't be split, but need a single comparison.
+    // see MaxProbes() for the resulting worst case.
+    ssize_t LutTwoLevelSearch(T key) const
+    {
+        const uint32_t mappedKey = MapValue<T>(key);
+        if (mappedKey < MinMapped || mappedKey > MaxMapped)
+            return -1;
+
+        const uint64_t lutPos = LutPosition(mappedKey);
+        const size_t lutIdx = lutPos>>32;
+        ssize_t start, end;
+        LutIntervalAt(lutIdx, start, end);
+
+        if (end-start >= (ssize_t)SplitThresh)
+        {
+            // unsplittable intervals hold values with equal mapped keys,
+            // i.e. copies of one value if the mapping is one-to-one
+            if (!SubLutInterval(lutIdx, (uint32_t)lutPos, start, end))
+                return (INJECTIVE_KEY_MAPPING<T> ? (KeyEqual(Vals[start], key) ? start : -1) : BinarySearch(start, end, key));
+            if (end < start)
+                return -1;
+        }
+
+        return BinarySearch(start, end, key);
+    }
+
+    // number of sub-LUTs of all levels
+    size_t NumSubLuts() const
+    {
+        return SubLuts.size();
+    }
+
+    // worst-case number of values LutTwoLevelSearch() compares a key with
+    size_t MaxProbes() const
+    {
+        return MaxProbeCount;
+    }
+
+    // ordered queries with the semantics of std::lower_bound() etc. keys
+    // outside of the values' range are answered without memory accesses,
+    // all other keys only search their LUT interval, no matter if they're
+    // contained or not. all copies of a value are in the same interval.
+
+    // index of the first value which isn't smaller than the key,
+    // number of values if there's none
+    size_t LowerBound(T key) const
+    {
+        ssize_t start, end;
+        if (!BoundInterval(key, start, end))
+            return start;
+        return ::LowerBound(Vals, start, end, key);
+    }
+
+    // index of the first value which is bigger than the key,
+    // number of values if there's none
+    size_t UpperBound(T key) const
+    {
+        ssize_t start, end;
+        if (!BoundInterval(key, start, end))
+            return start;
+        return ::UpperBound(Vals, start, end, key);
+    }
+
+    // range [first, last) of the values equal to the key
+    std::pair<size_t, size_t> EqualRange(T key) const
+    {
+        ssize_t start, end;
+        if (!BoundInterval(key, start, end))
+            return std::make_pair(start, start);
+
+        const size_t first = ::LowerBound(Vals, start, end, key);
+        return std::make_pair(first, ::UpperBound(Vals, first, end, key));
+    }
+
+    size_t Count(T key) const
+    {
+        const auto range = EqualRange(key);
+        return range.second-range.first;
+    }
+
+    // number of values smaller than the key
+    size_t Rank(T key) const
+    {
+        return LowerBound(key);
+    }
+
+    // index of the last value smaller than the key, -1 if there's none
+    ssize_t Predecessor(T key) const
+    {
+        return (ssize_t)LowerBound(key)-1;
+    }
+
+    // index of the first value bigger than the key, -1 if there's none
+    ssize_t Successor(T key) const
+    {
+        const size_t idx = UpperBound(key);
+        return (idx < Vals.size() ? (ssize_t)idx : -1);
+    }
+
+    // values in [lo, hi] without copying them. both ends are found with
+    // the LUT, the span can be passed to ScanSum() etc.
+    std::span<const T> Scan(T lo, T hi) const
+    {
+        const size_t first = LowerBound(lo);
+        const size_t last = std::max(UpperBound(hi), first);
+        return std::span<const T>(Vals.data()+first, last-first);
+    }
+
+    // largest interval length for which LutHybridSearch() scans linearly,
+    // DEFAULT_SCAN_THRESHOLD unless TuneScanThreshold() was called
+    size_t ScanThreshold() const
+    {
+        return ScanThresh;
+    }
+
+    // measures linear scan vs. binary search on random intervals of
+    // the data set with increasing lengths and keeps the largest length
+    // for which scanning was still faster. the result depends on the
+    // machine and its load, so it's not done by the constructor.
+    void TuneScanThreshold()
+    {
+        const size_t NUM_SAMPLES = 4096;
+        std::mt19937 gen(303);
+        std::vector<std::pair<size_t, size_t>> samples(NUM_SAMPLES);
+        ScanThresh = 0;
+
+        for (size_t len=8; len<=1024 && len<=Vals.size(); len*=2)
+        {
+            std::uniform_int_distribution<size_t> distStart(0, Vals.size()-len);
+            std::uniform_int_distribution<size_t> distOffset(0, len-1);
+            for (auto &s : samples)
+                s = std::make_pair(distStart(gen), distOffset(gen));
+
+            const auto timeAlgo = [&](ssize_t (SearchPod32::*algoFunc)(ssize_t, ssize_t, T) const)
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                volatile ssize_t res = 0;
+                for (const auto &s : samples)
+                    res = res+(this->*algoFunc)(s.first, s.first+len-1, Vals[s.first+s.second]);
+                return std::chrono::high_resolution_clock::now()-start;
+            };
+
+            if (timeAlgo(&SearchPod32::ScanSearch) >= timeAlgo(&SearchPod32::BinarySearch))
+                break;
+
+            ScanThresh = len;
+        }
+    }
+
+    // size of the look-up table in bytes
+    size_t MemoryFootprint() const
+    {
+        return Lut.MemoryFootprint()+SubLuts.size()*sizeof(SubLut)+SubLutEntries.size()*sizeof(uint32_t);
+    }
+
+    // interval [start, end] of values which have to be searched for the
+    // key. for mappings other than TopBits keys outside of the values'
+    // range are rejected without touching the LUT, in which case false is
+    // returned. with TopBits every key has a LUT entry, whose interval is
+    // empty or ends at the first or last value for such keys.
+    bool LutInterval(T key, ssize_t &start, ssize_t &end) const
+    {
+        const auto mappedKey = MapValue<T>(key);
+        if (MAPPING != LutMapping::TopBits && (mappedKey < MinMapped || mappedKey > MaxMapped))
+            return false;
+
+        LutIntervalAt(LutPosition(mappedKey)>>32, start, end);
+        return true;
+    }
+
+    // LUT index of a key. keys outside of the values' range get the
+    // index of the first or last LUT entry, so batched searches don't
+    // need a branch to handle them.
+    size_t LutIndex(T key) const
+    {
+        return MappedLutIndex(MapValue<T>(key));
+    }
+
+    // same for an already mapped key
+    size_t MappedLutIndex(uint32_t mappedKey) const
+    {
+        if constexpr (MAPPING == LutMapping::TopBits)
+            return LutPosition(mappedKey)>>32;
+        else
+            return LutPosition(std::min(std::max(mappedKey, MinMapped), MaxMapped))>>32;
+    }
+
+    // LUT interval of the key like LutInterval(). for keys outside of
+    // the values' range false is returned and start is set to their
+    // lower and upper bound: 0 or the number of values.
+    bool BoundInterval(T key, ssize_t &start, ssize_t &end) const
+    {
+        const auto mappedKey = MapValue<T>(key);
+        if (mappedKey < MinMapped || mappedKey > MaxMapped)
+        {
+            start = end = (mappedKey < MinMapped ? 0 : Vals.size());
+            return false;
+        }
+
+        LutIntervalAt(LutPosition(mappedKey)>>32, start, end);
+        return true;
+    }
+
+    void LutIntervalAt(size_t lutIdx, ssize_t &start, ssize_t &end) const
+    {
+        start = Lut[lutIdx];
+
+        // interval end of i-th LUT entry = interval start of (i+1)th LUT entry - 1.
+        // however, all LUT remaining LUT entries map to the last valid interval
+        // start => interval end < interval start => just use number of values
+        end = (lutIdx >= LutEnd ? Vals.size()-1 : Lut[lutIdx+1]-1);
+    }
+
+    // the intervals of the first NumLutIntervals() LUT entries
+    // are disjoint and cover all values in ascending order
+    size_t NumLutIntervals() const
+    {
+        return LutEnd+1;
+    }
+
+public:
+    static const size_t MAX_BATCH_GROUP = 64;
+    static const size_t DEFAULT_SCAN_THRESHOLD = 64;
+    static const size_t DEFAULT_SKEW_FACTOR = 8;
+
+private:
+    struct SubLut
+    {
+        uint64_t Key;    // LUT index, or NESTED_SUB_LUT|index of the parent's entry
+        uint32_t Base;   // key position prefix shared by all values of the interval
+        uint8_t  Shift;  // length of that prefix in bits
+        uint8_t  Bits;
+        size_t   Offset; // of first entry in SubLutEntries
+    };
+
+    static const uint64_t NESTED_SUB_LUT = (uint64_t)1<<63;
+    static const size_t   MAX_SUB_LUT_BITS = 16;
+
+    ssize_t BinarySearch(ssize_t left, ssize_t right, T key) const
+    {
+        return ::BinarySearch(Vals, left, right, key);
+    }
+
+    ssize_t BranchlessSearch(ssize_t left, ssize_t right, T key) const
+    {
+        return ::BranchlessSearch(Vals, left, right, key);
+    }
+
+    // narrows the oversized LUT interval [start, end] with its sub-LUTs
+    // until it holds at most MaxIntervalSize values; keyFrac is the key's
+    // position inside the LUT entry. returns false if the interval stays
+    // oversized, which only happens for runs of copies of one value.
+    bool SubLutInterval(size_t lutIdx, uint32_t keyFrac, ssize_t &start, ssize_t &end) const
+    {
+        const SubLut *sl = FindSubLut(lutIdx);
+
+        while (sl)
+        {
+            const uint32_t subIdx = (keyFrac-sl->Base)>>(32-sl->Shift-sl->Bits);
+            if (keyFrac < sl->Base || subIdx >= ((uint32_t)1<<sl->Bits))
+            {
+                // key before or behind all values of the interval
+                start = (keyFrac < sl->Base ? start : end+1);
+                end = start-1;
+                return true;
+            }
+
+            const uint32_t *entries = &SubLutEntries[sl->Offset];
+            end = start+entries[subIdx+1]-1;
+            start = start+entries[subIdx];
+            if (end-start < (ssize_t)MaxIntervalSize)
+                return true;
+
+            sl = FindSubLut(NESTED_SUB_LUT|(sl->Offset+subIdx));
+        }
+
+        return false;
+    }
+
+    // only few intervals are split => binary search their keys
+    const SubLut * FindSubLut(uint64_t key) const
+    {
+        const auto iter = std::lower_bound(SubLuts.begin(), SubLuts.end(), key, [](const SubLut &sl, uint64_t key)
+        {
+            return sl.Key < key;
+        });
+
+        return (iter != SubLuts.end() && iter->Key == key ? &*iter : nullptr);
+    }
+
+    // exponential search outwards from guess for the interval
+    // containing the lower bound, followed by a binary search
+    ssize_t GallopSearch(ssize_t left, ssize_t right, ssize_t guess, T key) const
+    {
+        ssize_t step = 1;
+
+        if (KeyLess(Vals[guess], key))
+        {
+            // lower bound in [guess+1, right+1]
+            left = guess+1;
+            while (true)
+            {
+                const ssize_t probe = left+step-1;
+                if (probe >= right)
+                    break;
+                if (!KeyLess(Vals[probe], key))
+                {
+                    right = probe;
+                    break;
+                }
+
+                left = probe+1;
+                step <<= 1;
+            }
+
+            if (left > right)
+                return -1;
+        }
+        else
+        {
+            // lower bound in [left, guess]
+            right = guess;
+            while (true)
+            {
+                const ssize_t probe = right-step;
+                if (probe < left)
+                    break;
+                if (KeyLess(Vals[probe], key))
+                {
+                    left = probe+1;
+                    break;
+                }
+
+                right = probe;
+                step <<= 1;
+            }
+        }
+
+        return BinarySearch(left, right, key);
+    }
+
+    ssize_t ScanSearch(ssize_t left, ssize_t right, T key) const
+    {
+        const size_t len = (right >= left ? right-left+1 : 0);
+        const ssize_t idx = left+SimdCountLess(&Vals[left], len, key);
+        return (idx <= right && KeyEqual(Vals[idx], key) ? idx : -1);
+    }
+
+    // builds the sub-LUTs of all skewed LUT intervals and tracks the
+    // worst-case probe count
+    void InitSubLuts()
+    {
+        const size_t avgIntervalSize = (Vals.size()>>LUT_BITS)+1;
+        SplitThresh = std::max(MaxIntervalSize, SkewFactor*avgIntervalSize);
+        MaxProbeCount = 0;
+
+        for (size_t i=0; i<NumLutIntervals(); i++)
+        {
+            ssize_t start, end;
+            LutIntervalAt(i, start, end);
+            AddSubLut(i, start, end, SplitThresh);
+        }
+
+        std::sort(SubLuts.begin(), SubLuts.end(), [](const SubLut &a, const SubLut &b)
+        {
+            return a.Key < b.Key;
+        });
+    }
+
+    // adds a sub-LUT for the values [start, end] if there are more than
+    // maxLen of them, and recursively for its intervals with more than
+    // MaxIntervalSize values.
+    // like LutMapping::CommonPrefix it skips the prefix of the key position
+    // shared by all values, and it uses enough of the following bits that
+    // its intervals hold about MaxIntervalSize/4 values for uniformly
+    // distributed data. entries are relative to start.
+    void AddSubLut(uint64_t key, ssize_t start, ssize_t end, size_t maxLen)
+    {
+        const size_t len = (end >= start ? end-start+1 : 0);
+        // ceil(log2(len)) iterations of BinarySearch() + the final comparison
+        const size_t probes = (len > 1 ? 64-__builtin_clzll(len-1) : 0)+1;
+
+        if (len <= maxLen)
+        {
+            MaxProbeCount = std::max(MaxProbeCount, probes);
+            return;
+        }
+
+        // only bits which differ between the values can split the interval
+        const uint32_t firstFrac = KeyFraction(Vals[start]);
+        uint32_t diffBits = 0;
+        for (ssize_t i=start+1; i<=end; i++)
+            diffBits |= KeyFraction(Vals[i])^firstFrac;
+
+        if (diffBits == 0)
+        {
+            // copies of one value, found with one comparison, if the
+            // mapping is one-to-one. otherwise the values only share
+            // their mapped key and are binary searched.
+            MaxProbeCount = std::max(MaxProbeCount, (INJECTIVE_KEY_MAPPING<T> ? (size_t)1 : probes));
+            return;
+        }
+
+        assert(len <= std::numeric_limits<uint32_t>::max());
+        const size_t shift = __builtin_clz(diffBits);
+        const size_t maxBits = std::min(32-shift-__builtin_ctz(diffBits), (size_t)MAX_SUB_LUT_BITS);
+        size_t bits = 1;
+        while (bits < maxBits && (len>>bits) > std::max(MaxIntervalSize/4, (size_t)1))
+            bits++;
+
+        const SubLut sl = {key, (shift == 0 ? 0 : firstFrac&~(0xffffffffu>>shift)), (uint8_t)shift, (uint8_t)bits, SubLutEntries.size()};
+        SubLuts.push_back(sl);
+        SubLutEntries.resize(SubLutEntries.size()+((size_t)1<<bits)+1);
+
+        // entries[j] = number of values whose next bits are < j
+        size_t pos = 0;
+        for (size_t j=0; j<=((size_t)1<<bits); j++)
+        {
+            while (pos < len && ((KeyFraction(Vals[start+pos])-sl.Base)>>(32-shift-bits)) < j)
+                pos++;
+            SubLutEntries[sl.Offset+j] = (uint32_t)pos;
+        }
+
+        for (size_t j=0; j<((size_t)1<<bits); j++)
+            AddSubLut(NESTED_SUB_LUT|(sl.Offset+j), start+SubLutEntries[sl.Offset+j], start+SubLutEntries[sl.Offset+j+1]-1, MaxIntervalSize);
+    }
+
+    // position of a mapped key in [MinMapped, MaxMapped] inside the LUT as
+    // 32.32 fixed point number: the integer part is the LUT index and the
+    // fraction is the position inside the key range of the LUT entry
+    uint64_t LutPosition(uint32_t mappedKey) const
+    {
+        if constexpr (MAPPING == LutMapping::TopBits)
+            return (uint64_t)mappedKey<<LUT_BITS;
+        else
+            return (uint64_t)(mappedKey-LutBase)*LutScale;
+    }
+
+    // position of a value inside its LUT entry as 0.32 fixed point number
+    uint32_t KeyFraction(T val) const
+    {
+        return (uint32_t)LutPosition(MapValue<T>(val));
+    }
+
+    void InitLutMapping()
+    {
+        MinMapped = MapValue<T>(Vals.front());
+        MaxMapped = MapValue<T>(Vals.back());
+
+        if (MAPPING == LutMapping::TopBits)
+        {
+            // only for documentation, LutPosition() shifts instead
+            LutBase = 0;
+            LutScale = (uint64_t)1<<LUT_BITS;
+        }
+        else if (MAPPING == LutMapping::CommonPrefix)
+        {
+            // skip the prefix all values share, i.e. shift it out
+            const size_t prefixLen = (MinMapped == MaxMapped ? 31 : __builtin_clz(MinMapped^MaxMapped));
+            LutBase = (prefixLen == 0 ? 0 : MinMapped&~(0xffffffffu>>prefixLen));
+            LutScale = (uint64_t)1<<(LUT_BITS+prefixLen);
+        }
+        else
+        {
+            // largest scale which maps MaxMapped into the last LUT entry
+            LutBase = MinMapped;
+            LutScale = ((uint64_t)1<<(32+LUT_BITS))/((uint64_t)(MaxMapped-MinMapped)+1);
+        }
+    }
+
+    void InitLut()
+    {
+        // one additional element to avoid condition in interval end computation
+        Lut.Build(BuildLut(Vals.size(), ((size_t)1<<LUT_BITS)+1, LutEnd, [this](size_t i)
+        {
+            return LutPosition(MapValue<T>(Vals[i]))>>32;
+        }));
+    }
+
+private:
+    LUT                    Lut;
+    const std::vector<T> & Vals;
+    size_t                 LutEnd;
+    uint32_t               MinMapped;
+    uint32_t               MaxMapped;
+    uint32_t               LutBase;
+    uint64_t               LutScale;
+    size_t                 ScanThresh;
+    size_t                 MaxIntervalSize;
+    size_t                 SkewFactor;
+    size_t                 SplitThresh; // LUT intervals with more values have a sub-LUT
+    std::vector<SubLut>    SubLuts; // sorted by key
+    std::vector<uint32_t>  SubLutEntries;
+    size_t                 MaxProbeCount;
+};
+
+// LUT optimized binary search with the LUT size chosen at run-time.
+// the LUT gets the fewest bits for which no LUT interval holds more than
+// maxIntervalSize values (by default 64 values = a few cache lines which
+// stay in L1), given the LUT fits into memoryBudget bytes. if no allowed
+// size reaches the target, e.g. for heavily clustered values, the fewest
+// bits giving the smallest largest interval are used. the shift is the
+// only run-time difference in the hot path compared to SearchPod32.
+template<class T> class DynSearchPod32
+{
+public:
+    DynSearchPod32(const std::vector<T> &vals, size_t maxIntervalSize=64, size_t memoryBudget=64*1024*1024) :
+        Vals(vals)
+    {
+        LutBits = ChooseLutBits(maxIntervalSize, memoryBudget);
+        LutShift = 32-LutBits;
+        InitLut();
+    }
+
+    ssize_t StdBinarySearch(T key) const
+    {
+        return ::StdBinarySearch(Vals, key);
+    }
+
+    ssize_t MyBinarySearch(T key) const
+    {
+        return BinarySearch(Vals, 0, (ssize_t)Vals.size()-1, key);
+    }
+
+    ssize_t LutBinarySearch(T key) const
+    {
+        const size_t lutIdx = MapValue<T>(key)>>LutShift;
+        const ssize_t start = Lut[lutIdx];
+        const ssize_t end = (lutIdx >= LutEnd ? Vals.size()-1 : Lut[lutIdx+1]-1);
+        return BinarySearch(Vals, start, end, key);
+    }
+
+    size_t NumLutBits() const
+    {
+        return LutBits;
+    }
+
+    size_t MemoryFootprint() const
+    {
+        return Lut.size()*sizeof(Lut[0]);
+    }
+
+private:
+    size_t ChooseLutBits(size_t maxIntervalSize, size_t memoryBudget) const
+    {
+        size_t maxBits = 1;
+        while (maxBits < 30 && (((size_t)2<<maxBits)+1)*sizeof(size_t) <= memoryBudget)
+            maxBits++;
+
+        // histogram for the largest size; halving it gives the next smaller size
+        std::vector<size_t> counts((size_t)1<<maxBits, 0);
+        for (const auto &v : Vals)
+            counts[MapValue<T>(v)>>(32-maxBits)]++;
+
+        std::vector<size_t> maxCounts(maxBits+1, 0);
+        for (size_t bits=maxBits; bits>0; bits--)
+        {
+            maxCounts[bits] = *std::max_element(counts.begin(), counts.end());
+            for (size_t i=0; i<counts.size()/2; i++)
+                counts[i] = counts[2*i]+counts[2*i+1];
+            counts.resize(counts.size()/2);
+        }
+
+        const size_t minMaxCount = *std::min_element(maxCounts.begin()+1, maxCounts.end());
+        for (size_t bits=1; bits<maxBits; bits++)
+        {
+            if (maxCounts[bits] <= std::max(maxIntervalSize, minMaxCount))
+                return bits;
+        }
+
+        return maxBits;
+    }
+
+    void InitLut()
+    {
+        Lut = BuildLut(Vals.size(), ((size_t)1<<LutBits)+1, LutEnd, [this](size_t i)
+        {
+            return MapValue<T>(Vals[i])>>LutShift;
+        });
+    }
+
+private:
+    std::vector<size_t>    Lut;
+    const std::vector<T> & Vals;
+    size_t                 LutEnd;
+    size_t                 LutBits;
+    uint32_t               LutShift;
+};
+
+// search for 8-bit and 16-bit types with a LUT covering the whole key
+// space: the LUT holds the number of values smaller than each possible
+// key, so the key's LUT entry and the next one are the start and the end
+// of its range of values. no value is ever compared. it offers the
+// search functions of SearchPod32, LutSearchPod selects it automatically.
+template<class T, class LUT=PlainLut<size_t>> class DirectSearchPod
+{
+public:
+    static const size_t KEY_BITS = MAPPED_KEY_BITS<T>;
+
+    // the LUT intervals only hold copies of a value, so
+    // there's no interval size to limit, unlike for SearchPod32
+    DirectSearchPod(const std::vector<T> &vals, size_t /*maxIntervalSize*/=256, size_t /*skewFactor*/=0) :
+        Vals(vals)
+    {
+        static_assert(KEY_BITS <= 16, "direct address LUT only supported for types mapped to 8 or 16 bits");
+        static_assert(INJECTIVE_KEY_MAPPING<T>, "direct address LUT requires a one-to-one key mapping: use SearchPod32");
+        InitLut();
+    }
+
+    ssize_t StdBinarySearch(T key) const
+    {
+        return ::StdBinarySearch(Vals, key);
+    }
+
+    ssize_t MyBinarySearch(T key) const
+    {
+        return BinarySearch(Vals, 0, (ssize_t)Vals.size()-1, key);
+    }
+
+    ssize_t LutBinarySearch(T key) const
+    {
+        ssize_t start, end;
+        LutInterval(key, start, end);
+        return (end >= start ? start : -1);
+    }
+
+    ssize_t LutBranchlessSearch(T key) const
+    {
+        return LutBinarySearch(key);
+    }
+
+    ssize_t LutHybridSearch(T key) const
+    {
+        return LutBinarySearch(key);
+    }
+
+    ssize_t LutInterpolationSearch(T key) const
+    {
+        return LutBinarySearch(key);
+    }
+
+    ssize_t LutTwoLevelSearch(T key) const
+    {
+        return LutBinarySearch(key);
+    }
+
+    // each key only needs its two LUT entries, so there's nothing to interleave
+    void LutBinarySearchBatch(std::span<const T> keys, std::span<ssize_t> out, size_t /*groupSize*/=16) const
+    {
+        assert(keys.size() == out.size());
+        for (size_t i=0; i<keys.size(); i++)
+            out[i] = LutBinarySearch(keys[i]);
+    }
+
+    void LutSortedBatchSearch(std::span<const T> keys, std::span<ssize_t> out, bool /*keysSorted*/=false) const
+    {
+        LutBinarySearchBatch(keys, out);
+    }
+
+    // LutBinarySearch() as coroutine which suspends after prefetching the LUT entry
+    SearchTask LutBinarySearchTask(T key) const
+    {
+        const size_t lutIdx = LutIndex(key);
+        Lut.Prefetch(lutIdx);
+        co_await std::suspend_always();
+
+        ssize_t start, end;
+        LutIntervalAt(lutIdx, start, end);
+        co_return (end >= start ? start : -1);
+    }
+
+    // ordered queries like SearchPod32's. the LUT holds the number of
+    // values smaller than each key, so they're answered from the key's
+    // LUT entry and the next one without comparing any value.
+
+    size_t LowerBound(T key) const
+    {
+        return Lut[LutIndex(key)];
+    }
+
+    size_t UpperBound(T key) const
+    {
+        return Lut[LutIndex(key)+1];
+    }
+
+    std::pair<size_t, size_t> EqualRange(T key) const
+    {
+        const size_t lutIdx = LutIndex(key);
+        return std::make_pair(Lut[lutIdx], Lut[lutIdx+1]);
+    }
+
+    size_t Count(T key) const
+    {
+        const auto range = EqualRange(key);
+        return range.second-range.first;
+    }
+
+    size_t Rank(T key) const
+    {
+        return LowerBound(key);
+    }
+
+    ssize_t Predecessor(T key) const
+    {
+        return (ssize_t)LowerBound(key)-1;
+    }
+
+    ssize_t Successor(T key) const
+    {
+        const size_t idx = UpperBound(key);
+        return (idx < Vals.size() ? (ssize_t)idx : -1);
+    }
+
+    // values in [lo, hi] without copying them, like SearchPod32::Scan()
+    std::span<const T> Scan(T lo, T hi) const
+    {
+        const size_t first = LowerBound(lo);
+        const size_t last = std::max(UpperBound(hi), first);
+        return std::span<const T>(Vals.data()+first, last-first);
+    }
+
+    // there are no sub-LUTs and no value is compared with the key
+    size_t NumSubLuts() const
+    {
+        return 0;
+    }
+
+    size_t MaxProbes() const
+    {
+        return 0;
+    }
+
+    // nothing is scanned either
+    size_t ScanThreshold() const
+    {
+        return 0;
+    }
+
+    void TuneScanThreshold()
+    {
+    }
+
+    // size of the look-up table in bytes
+    size_t MemoryFootprint() const
+    {
+        return Lut.MemoryFootprint();
+    }
+
+    // same as LutInterval(), every key is inside of the key space
+    bool BoundInterval(T key, ssize_t &start, ssize_t &end) const
+    {
+        return LutInterval(key, start, end);
+    }
+
+    // interval [start, end] of the values equal to the key. it's empty if
+    // the key isn't contained. always returns true, as in SearchPod32 it
+    // tells if the key is inside of the values' range.
+    bool LutInterval(T key, ssize_t &start, ssize_t &end) const
+    {
+        LutIntervalAt(LutIndex(key), start, end);
+        return true;
+    }
+
+    size_t LutIndex(T key) const
+    {
+        return MappedLutIndex(MapValue<T>(key));
+    }
+
+    // same for an already mapped key
+    size_t MappedLutIndex(uint32_t mappedKey) const
+    {
+        return mappedKey>>(32-KEY_BITS);
+    }
+
+    void LutIntervalAt(size_t lutIdx, ssize_t &start, ssize_t &end) const
+    {
+        start = Lut[lutIdx];
+        end = (ssize_t)Lut[lutIdx+1]-1;
+    }
+
+    size_t NumLutIntervals() const
+    {
+        return (size_t)1<<KEY_BITS;
+    }
+
+private:
+    void InitLut()
+    {
+        // count the values per key, the prefix sums are the interval starts
+        std::vector<size_t> lut(((size_t)1<<KEY_BITS)+1, 0);
+        for (const auto &v : Vals)
+            lut[LutIndex(v)+1]++;
+        for (size_t i=1; i<lut.size(); i++)
+            lut[i] += lut[i-1];
+
+        Lut.Build(std::move(lut));
+    }
+
+private:
+    LUT                    Lut;
+    const std::vector<T> & Vals;
+};
+
+// LUT optimized search for the type: DirectSearchPod if the LUT covers
+// the whole key space and the mapping is one-to-one, otherwise
+// SearchPod32 with a LUT no bigger than the key space
+template<class T, size_t LUT_BITS, class LUT=PlainLut<size_t>> using LutSearchPod =
+    std::conditional_t<(LUT_BITS >= MAPPED_KEY_BITS<T> && INJECTIVE_KEY_MAPPING<T>), DirectSearchPod<T, LUT>,
+                       SearchPod32<T, std::min(LUT_BITS, MAPPED_KEY_BITS<T>), LUT>>;
+
+// LUT optimized binary search implementation for 64-bit POD types. the
+// LUT is indexed by the top LUT_BITS bits of the 64-bit mapped key after
+// the prefix shared by all values, so it works like SearchPod32 with
+// LutMapping::CommonPrefix. that matters more for 64-bit keys, e.g.
+// timestamps or packed tuples, which often leave the top bits unused.
+// the mapped values are only used to build the LUT and to reject keys
+// outside of the values' range; the search itself compares the keys.
+template<class T, size_t LUT_BITS, class LUT=PlainLut<size_t>> class SearchPod64
+{
+public:
+    SearchPod64(const std::vector<T> &vals) :
+        Vals(vals)
+    {
+        static_assert(LUT_BITS > 0 && LUT_BITS < 32, "invalid binary search LUT size");
+        MinMapped = MapValue64<T>(Vals.front());
+        MaxMapped = MapValue64<T>(Vals.back());
+        PrefixLen = (MinMapped == MaxMapped ? 63 : __builtin_clzll(MinMapped^MaxMapped));
+        InitLut();
+    }
+
+    ssize_t StdBinarySearch(T key) const
+    {
+        return ::StdBinarySearch(Vals, key);
+    }
+
+    ssize_t MyBinarySearch(T key) const
+    {
+        return BinarySearch(Vals, 0, (ssize_t)Vals.size()-1, key);
+    }
+
+    ssize_t LutBinarySearch(T key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end))
+            return -1;
+        return BinarySearch(Vals, start, end, key);
+    }
+
+    ssize_t LutBranchlessSearch(T key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end))
+            return -1;
+        return BranchlessSearch(Vals, start, end, key);
+    }
+
+    // index of the first value which isn't smaller than the key,
+    // number of values if there's none
+    size_t LowerBound(T key) const
+    {
+        const uint64_t mappedKey = MapValue64<T>(key);
+        if (mappedKey < MinMapped)
+            return 0;
+        if (mappedKey > MaxMapped)
+            return Vals.size();
+
+        ssize_t start, end;
+        LutIntervalAt(LutIndex(mappedKey), start, end);
+        return ::LowerBound(Vals, start, end, key);
+    }
+
+    // index of the first value which is bigger than the key,
+    // number of values if there's none
+    size_t UpperBound(T key) const
+    {
+        const uint64_t mappedKey = MapValue64<T>(key);
+        if (mappedKey < MinMapped)
+            return 0;
+        if (mappedKey > MaxMapped)
+            return Vals.size();
+
+        ssize_t start, end;
+        LutIntervalAt(LutIndex(mappedKey), start, end);
+        return ::UpperBound(Vals, start, end, key);
+    }
+
+    // range [first, last) of the values equal to the key
+    std::pair<size_t, size_t> EqualRange(T key) const
+    {
+        const size_t first = LowerBound(key);
+        return std::make_pair(first, std::max(UpperBound(key), first));
+    }
+
+    // values in [lo, hi] without copying them, like SearchPod32::Scan()
+    std::span<const T> Scan(T lo, T hi) const
+    {
+        const size_t first = LowerBound(lo);
+        const size_t last = std::max(UpperBound(hi), first);
+        return std::span<const T>(Vals.data()+first, last-first);
+    }
+
+    // size of the look-up table in bytes
+    size_t MemoryFootprint() const
+    {
+        return Lut.MemoryFootprint();
+    }
+
+    // same as SearchPod32::LutInterval()
+    bool LutInterval(T key, ssize_t &start, ssize_t &end) const
+    {
+        const uint64_t mappedKey = MapValue64<T>(key);
+        if (mappedKey < MinMapped || mappedKey > MaxMapped)
+            return false;
+
+        LutIntervalAt(LutIndex(mappedKey), start, end);
+        return true;
+    }
+
+    void LutIntervalAt(size_t lutIdx, ssize_t &start, ssize_t &end) const
+    {
+        start = Lut[lutIdx];
+        end = (lutIdx >= LutEnd ? Vals.size()-1 : Lut[lutIdx+1]-1);
+    }
+
+    size_t NumLutIntervals() const
+    {
+        return LutEnd+1;
+    }
+
+private:
+    // only for keys inside of the values' range, which share the prefix
+    size_t LutIndex(uint64_t mappedKey) const
+    {
+        return (mappedKey<<PrefixLen)>>(64-LUT_BITS);
+    }
+
+    void InitLut()
+    {
+        Lut.Build(BuildLut(Vals.size(), ((size_t)1<<LUT_BITS)+1, LutEnd, [this](size_t i)
+        {
+            return LutIndex(MapValue64<T>(Vals[i]));
+        }));
+    }
+
+private:
+    LUT                    Lut;
+    const std::vector<T> & Vals;
+    size_t                 LutEnd;
+    uint64_t               MinMapped;
+    uint64_t               MaxMapped;
+    size_t                 PrefixLen;
+};
+
+// 128-bit key, e.g. an UUID or a pair of 64-bit values, ordered by the
+// high word first
+struct Key128
+{
+    uint64_t Hi;
+    uint64_t Lo;
+
+    bool operator<(const Key128 &other) const
+    {
+        return (Hi < other.Hi || (Hi == other.Hi && Lo < other.Lo));
+    }
+
+    bool operator==(const Key128 &other) const
+    {
+        return (Hi == other.Hi && Lo == other.Lo);
+    }
+};
+
+enum class Key128Layout
+{
+    Interleaved, // searches the Key128 values in place
+    Split        // searches a copy with high and low words in separate arrays
+};
+
+// LUT optimized binary search implementation for 128-bit keys. the LUT is
+// indexed by the top LUT_BITS bits of the high word after the prefix
+// shared by all values, like in SearchPod64. the LUT interval is
+// searched comparing high words first, so the low word is only read if
+// the high words are equal. with the split layout the low words are in
+// a separate array and therefore never pulled into the cache by probes
+// which are decided by the high word, at the cost of a copy of the keys.
+template<size_t LUT_BITS, class LUT=PlainLut<size_t>> class SearchPod128
+{
+public:
+    SearchPod128(const std::vector<Key128> &vals, Key128Layout layout=Key128Layout::Interleaved) :
+        Vals(vals),
+        Layout(layout)
+    {
+        static_assert(LUT_BITS > 0 && LUT_BITS < 32, "invalid binary search LUT size");
+
+        if (Layout == Key128Layout::Split)
+        {
+            HiWords.resize(Vals.size());
+            LoWords.resize(Vals.size());
+            for (size_t i=0; i<Vals.size(); i++)
+            {
+                HiWords[i] = Vals[i].Hi;
+                LoWords[i] = Vals[i].Lo;
+            }
+        }
+
+        const uint64_t diff = Vals.front().Hi^Vals.back().Hi;
+        PrefixLen = (diff == 0 ? 63 : __builtin_clzll(diff));
+        InitLut();
+    }
+
+    ssize_t StdBinarySearch(Key128 key) const
+    {
+        return ::StdBinarySearch(Vals, key);
+    }
+
+    ssize_t MyBinarySearch(Key128 key) const
+    {
+        return BinarySearch(Vals, 0, (ssize_t)Vals.size()-1, key);
+    }
+
+    ssize_t LutBinarySearch(Key128 key) const
+    {
+        ssize_t start, end;
+        if (!LutInterval(key, start, end))
+            return -1;
+        return (Layout == Key128Layout::Split ? SplitSearch(start, end, key) : BinarySearch(Vals, start, end, key));
+    }
+
+    // index of the first value which isn't smaller than the key,
+    // number of values if there's none
+    size_t LowerBound(Key128 key) const
+    {
+        if (key.Hi < Vals.front().Hi)
+            return 0;
+        if (key.Hi > Vals.back().Hi)
+            return Vals.size();
+
+        ssize_t start, end;
+        LutIntervalAt(LutIndex(key.Hi), start, end);
+        return (Layout == Key128Layout::Split ? SplitLowerBound(start, end, key) : ::LowerBound(Vals, start, end, key));
+    }
+
+    // size of the look-up table and the split copy of the keys in bytes
+    size_t MemoryFootprint() const
+    {
+        return Lut.MemoryFootprint()+(HiWords.size()+LoWords.size())*sizeof(uint64_t);
+    }
+
+    // same as SearchPod32::LutInterval()
+    bool LutInterval(Key128 key, ssize_t &start, ssize_t &end) const
+    {
+        if (key.Hi < Vals.front().Hi || key.Hi > Vals.back().Hi)
+            return false;
+
+        LutIntervalAt(LutIndex(key.Hi), start, end);
+        return true;
+    }
+
+    void LutIntervalAt(size_t lutIdx, ssize_t &start, ssize_t &end) const
+    {
+        start = Lut[lutIdx];
+        end = (lutIdx >= LutEnd ? Vals.size()-1 : Lut[lutIdx+1]-1);
+    }
+
+    size_t NumLutIntervals() const
+    {
+        return LutEnd+1;
+    }
+
+private:
+    // only for keys inside of the values' range, which share the prefix
+    size_t LutIndex(uint64_t hi) const
+    {
+        return (hi<<PrefixLen)>>(64-LUT_BITS);
+    }
+
+    // BinarySearch() on the split high and low words
+    ssize_t SplitSearch(ssize_t left, ssize_t right, Key128 key) const
+    {
+        const size_t idx = SplitLowerBound(left, right, key);
+        return (idx < Vals.size() && HiWords[idx] == key.Hi && LoWords[idx] == key.Lo ? idx : -1);
+    }
+
+    // LowerBound() on the split high and low words
+    size_t SplitLowerBound(ssize_t left, ssize_t right, Key128 key) const
+    {
+        const uint64_t *hi = HiWords.data();
+        const uint64_t *lo = LoWords.data();
+
+        if (left > right)
+            return left;
+
+        while (left < right)
+        {
+            const auto mid = left+((right-left)>>1);
+            if (hi[mid] < key.Hi || (hi[mid] == key.Hi && lo[mid] < key.Lo))
+                left = mid+1;
+            else
+                right = mid;
+        }
+
+        return (hi[left] < key.Hi || (hi[left] == key.Hi && lo[left] < key.Lo) ? left+1 : left);
+    }
+
+    void InitLut()
+    {
+        Lut.Build(BuildLut(Vals.size(), ((size_t)1<<LUT_BITS)+1, LutEnd, [this](size_t i)
+        {
+            return LutIndex(Vals[i].Hi);
+        }));
+    }
+
+private:
+    LUT                         Lut;
+    const std::vector<Key128> & Vals;
+    const Key128Layout          Layout;
+    std::vector<uint64_t>       HiWords;
+    std::vector<uint64_t>       LoWords;
+    size_t                      LutEnd;
+    size_t                      PrefixLen;
+};
+
+// LUT optimized search in a sorted set of strings or other byte sequences.
+// the strings are copied into one contiguous arena, addressed by an offsets
+// array. the LUT is indexed by the top bits of a big-endian PREFIX (4 or 8
+// bytes) of each string, cached in an array of its own, so the interval
+// search compares the cached prefixes and only reads the strings if the
+// prefixes are equal. like LutMapping::CommonPrefix the bytes shared by all
+// strings (e.g. "https://") are skipped, so that the prefixes are taken
+// from the bytes which actually differ.
+template<size_t LUT_BITS, class PREFIX=uint64_t> class SearchString
+{
+public:
+    SearchString(const std::vector<std::string> &sorted)
+    {
+        static_assert(std::is_same_v<PREFIX, uint32_t> || std::is_same_v<PREFIX, uint64_t>, "string prefix must be 4 or 8 bytes");
+        static_assert(LUT_BITS > 0 && LUT_BITS < 32, "invalid binary search LUT size");
+        assert(!sorted.empty());
+
+        Offsets.reserve(sorted.size()+1);
+        Offsets.push_back(0);
+        for (const auto &str : sorted)
+        {
+            Arena.insert(Arena.end(), str.begin(), str.end());
+            Offsets.push_back(Arena.size());
+        }
+
+        // first and last string share their prefix with all strings in between
+        const std::string_view first = String(0), last = String(sorted.size()-1);
+        SkipLen = std::mismatch(first.begin(), first.end(), last.begin(), last.end()).first-first.begin();
+
+        Prefixes.resize(sorted.size());
+        for (size_t i=0; i<sorted.size(); i++)
+            Prefixes[i] = Prefix(String(i));
+
+        InitLut();
+    }
+
+    // binary search on the arena without LUT and cached prefixes
+    ssize_t MyBinarySearch(std::string_view key) const
+    {
+        ssize_t left = 0, right = Size()-1;
+
+        while (left < right)
+        {
+            const auto mid = left+((right-left)>>1);
+            if (String(mid) < key)
+                left = mid+1;
+            else
+                right = mid;
+        }
+
+        return (String(left) == key ? left : -1);
+    }
+
+    ssize_t LutBinarySearch(std::string_view key) const
+    {
+        // strings not sharing the common prefix can't be contained
+        if (key.compare(0, SkipLen, String(0), 0, SkipLen) != 0)
+            return -1;
+
+        const PREFIX keyPrefix = Prefix(key);
+        if (keyPrefix < Prefixes.front() || keyPrefix > Prefixes.back())
+            return -1;
+
+        const size_t lutIdx = keyPrefix>>(PREFIX_BITS-LUT_BITS);
+        ssize_t left = Lut[lutIdx];
+        ssize_t right = (lutIdx >= LutEnd ? Size()-1 : Lut[lutIdx+1]-1);
+
+        // same as BinarySearch(), comparing prefixes first
+        while (left < right)
+        {
+            const auto mid = left+((right-left)>>1);
+            if (Prefixes[mid] < keyPrefix || (Prefixes[mid] == keyPrefix && String(mid) < key))
+                left = mid+1;
+            else
+                right = mid;
+        }
+
+        return (Prefixes[left] == keyPrefix && String(left) == key ? left : -1);
+    }
+
+    std::string_view String(size_t idx) const
+    {
+        return std::string_view(Arena.data()+Offsets[idx], Offsets[idx+1]-Offsets[idx]);
+    }
+
+    size_t Size() const
+    {
+        return Offsets.size()-1;
+    }
+
+    // number of leading bytes shared by all strings
+    size_t CommonPrefixLength() const
+    {
+        return SkipLen;
+    }
+
+    // size of the look-up table and the cached prefixes in bytes
+    size_t MemoryFootprint() const
+    {
+        return Lut.MemoryFootprint()+Prefixes.size()*sizeof(PREFIX);
+    }
+
+private:
+    static const size_t PREFIX_BITS = 8*sizeof(PREFIX);
+
+    // big-endian PREFIX of the bytes following the common prefix,
+    // padded with zeros, so that prefixes compare like the strings
+    PREFIX Prefix(std::string_view str) const
+    {
+        const size_t len = (str.size() > SkipLen ? std::min(str.size()-SkipLen, sizeof(PREFIX)) : 0);
+        uint8_t bytes[sizeof(PREFIX)] = {};
+        std::memcpy(bytes, str.data()+SkipLen, len);
+
+        PREFIX prefix = 0;
+        for (size_t i=0; i<sizeof(PREFIX); i++)
+            prefix = (prefix<<8)|bytes[i];
+        return prefix;
+    }
+
+    void InitLut()
+    {
+        Lut.Build(BuildLut(Prefixes.size(), ((size_t)1<<LUT_BITS)+1, LutEnd, [this](size_t i)
+        {
+            return (size_t)(Prefixes[i]>>(PREFIX_BITS-LUT_BITS));
+        }));
+    }
+
+private:
+    PlainLut<size_t>    Lut;
+    std::vector<char>   Arena;
+    std::vector<size_t> Offsets; // string i = Arena[Offsets[i]] ... Arena[Offsets[i+1]-1]
+    std::vector<PREFIX> Prefixes;
+    size_t              SkipLen;
+    size_t              LutEnd;
+};
+
+// LUT optimized search for sorted tuples, e.g. (tenant id, timestamp).
+// the fields' mappings are concatenated into one order-preserving
+// integer, the first field in the most significant bits. tuples of up to
+// 64 bits are searched with SearchPod64, up to 128 bits with SearchPod128,
+// on a packed copy of the tuples. a single integer comparison then
+// replaces the field-wise tuple comparison.
+template<size_t LUT_BITS, class... TS> class SearchTuple
+{
+public:
+    using Tuple = std::tuple<TS...>;
+
+    static const size_t TOTAL_BITS = (MAPPED_KEY_BITS<TS>+...);
+    static const size_t PACKED_BITS = (TOTAL_BITS <= 64 ? 64 : 128);
+    using Packed = std::conditional_t<(PACKED_BITS == 64), uint64_t, Key128>;
+    using Index = std::conditional_t<(PACKED_BITS == 64), SearchPod64<uint64_t, LUT_BITS>, SearchPod128<LUT_BITS>>;
+
+    SearchTuple(const std::vector<Tuple> &vals) :
+        Vals(vals),
+        PackedVals(PackAll(vals)),
+        Idx(PackedVals)
+    {
+        static_assert(TOTAL_BITS <= 128, "tuple's mapping is wider than 128 bits");
+        static_assert((INJECTIVE_KEY_MAPPING<TS> && ...), "packed tuples are compared instead of the tuples: requires one-to-one field mappings");
+    }
+
+    // the index refers to the packed values
+    SearchTuple(const SearchTuple &) = delete;
+    SearchTuple & operator=(const SearchTuple &) = delete;
+
+    ssize_t StdBinarySearch(const Tuple &key) const
+    {
+        return ::StdBinarySearch(Vals, key);
+    }
+
+    ssize_t LutBinarySearch(const Tuple &key) const
+    {
+        return Idx.LutBinarySearch(ToPacked(PackPrefix<sizeof...(TS)>(key)));
+    }
+
+    // range [first, last) of the tuples whose leading fields equal the
+    // prefix, e.g. all tuples of a tenant for a (tenant id) prefix
+    template<class... PREFIX_TS> std::pair<size_t, size_t> EqualRange(const std::tuple<PREFIX_TS...> &prefix) const
+    {
+        const size_t K = sizeof...(PREFIX_TS);
+        static_assert(K > 0 && K <= sizeof...(TS), "invalid prefix length");
+
+        // smallest and biggest packed tuple with that prefix
+        const Wide lo = PackPrefix<K>(prefix);
+        const Wide trailing = ((Wide)1<<(PACKED_BITS-PrefixBits(K)))-((Wide)1<<(PACKED_BITS-TOTAL_BITS));
+        const Wide hi = lo|trailing;
+        const bool hiIsMax = (TOTAL_BITS == PACKED_BITS && hi == MaxWide());
+
+        const size_t first = Idx.LowerBound(ToPacked(lo));
+        const size_t last = (hiIsMax ? Vals.size() : Idx.LowerBound(ToPacked(hi+1)));
+        return std::make_pair(first, last);
+    }
+
+    // size of the look-up table and the packed tuples in bytes
+    size_t MemoryFootprint() const
+    {
+        return Idx.MemoryFootprint()+PackedVals.size()*sizeof(Packed);
+    }
+
+private:
+    using Wide = unsigned __int128;
+
+    static constexpr size_t PrefixBits(size_t k)
+    {
+        const size_t bits[] = {MAPPED_KEY_BITS<TS>...};
+        size_t sum = 0;
+        for (size_t i=0; i<k; i++)
+            sum += bits[i];
+        return sum;
+    }
+
+    static constexpr Wide MaxWide()
+    {
+        return (PACKED_BITS == 128 ? ~(Wide)0 : ((Wide)1<<64)-1);
+    }
+
+    // concatenated mappings of the first K fields, left aligned
+    template<size_t K, class TUPLE> static Wide PackPrefix(const TUPLE &key)
+    {
+        Wide packed = 0;
+
+        [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            ((packed = (packed<<MAPPED_KEY_BITS<std::tuple_element_t<I, Tuple>>)|KeyTraits<std::tuple_element_t<I, Tuple>>::Map(std::get<I>(key))), ...);
+        }(std::make_index_sequence<K>());
+
+        return packed<<(PACKED_BITS-PrefixBits(K));
+    }
+
+    static Packed ToPacked(Wide packed)
+    {
+        if constexpr (PACKED_BITS == 64)
+            return (uint64_t)packed;
+        else
+            return Key128{(uint64_t)(packed>>64), (uint64_t)packed};
+    }
+
+    static std::vector<Packed> PackAll(const std::vector<Tuple> &vals)
+    {
+        std::vector<Packed> packed(vals.size());
+        for (size_t i=0; i<vals.size(); i++)
+            packed[i] = ToPacked(PackPrefix<sizeof...(TS)>(vals[i]));
+        return packed;
+    }
+
+private:
+    const std::vector<Tuple> & Vals;
+    const std::vector<Packed>  PackedVals;
+    const Index                Idx;
+};
+
+// sorted map which owns its keys and values. they are stored in separate
+// arrays, so searches only touch the keys and the values' cache lines are
+// only loaded for the result. keys are searched with LutSearchPod, i.e.
+// SearchPod32 or, for narrow keys, DirectSearchPod, and keys mapped to
+// more than 32 bits with SearchPod64. the keys are kept on the heap, so
+// that the index referring to them stays valid when the map is moved.
+template<class K, class V, size_t LUT_BITS> class LutFlatMap
+{
+public:
+    using Index = std::conditional_t<(MAPPED_KEY_BITS<K> > 32), SearchPod64<K, LUT_BITS>, LutSearchPod<K, LUT_BITS>>;
+
+    // bulk construction from unsorted pairs. for duplicate keys the
+    // first pair is kept, like for std::map::insert(). the index needs
+    // at least one key, so an empty map doesn't have one.
+    LutFlatMap(std::vector<std::pair<K, V>> pairs, size_t maxIntervalSize=256) :
+        Keys(new std::vector<K>(SortUnique(pairs))),
+        Values(ValueColumn(std::move(pairs))),
+        Idx(MakeIndex(*Keys, maxIntervalSize))
+    {
+    }
+
+    // moved-from maps can only be assigned to or destroyed
+    LutFlatMap(LutFlatMap &&) = default;
+    LutFlatMap & operator=(LutFlatMap &&) = default;
+
+    size_t Size() const
+    {
+        return Keys->size();
+    }
+
+    K Key(size_t idx) const
+    {
+        return (*Keys)[idx];
+    }
+
+    const V & Value(size_t idx) const
+    {
+        return Values[idx];
+    }
+
+    // index of the key or -1 if it's not contained
+    ssize_t Find(K key) const
+    {
+        return (Idx ? Idx->LutBinarySearch(key) : -1);
+    }
+
+    // value of the key or nullptr if it's not contained
+    const V * FindValue(K key) const
+    {
+        const ssize_t idx = Find(key);
+        return (idx >= 0 ? &Values[idx] : nullptr);
+    }
+
+    // index of the first key >= key, Size() if there's none
+    size_t LowerBound(K key) const
+    {
+        return (Idx ? Idx->LowerBound(key) : 0);
+    }
+
+    // index of the first key > key, Size() if there's none
+    size_t UpperBound(K key) const
+    {
+        return (Idx ? Idx->UpperBound(key) : 0);
+    }
+
+    // range [first, last) of the key, empty if it's not contained
+    std::pair<size_t, size_t> EqualRange(K key) const
+    {
+        return (Idx ? Idx->EqualRange(key) : std::pair<size_t, size_t>(0, 0));
+    }
+
+    // values of the keys in [lo, hi] without copying them
+    std::span<const V> ValueRange(K lo, K hi) const
+    {
+        if (!Idx)
+            return std::span<const V>();
+
+        const auto keys = Idx->Scan(lo, hi);
+        return std::span<const V>(Values.data()+(keys.data()-Keys->data()), keys.size());
+    }
+
+    // size of the look-up table, the keys and the values in bytes
+    size_t MemoryFootprint() const
+    {
+        return (Idx ? Idx->MemoryFootprint() : 0)+Keys->size()*sizeof(K)+Values.size()*sizeof(V);
+    }
+
+private:
+    static Index * MakeIndex(const std::vector<K> &keys, size_t maxIntervalSize)
+    {
+        if (keys.empty())
+            return nullptr;
+
+        // SearchPod64 doesn't split LUT intervals
+        if constexpr (MAPPED_KEY_BITS<K> > 32)
+            return new Index(keys);
+        else
+            return new Index(keys, maxIntervalSize);
+    }
+
+    // sorts the pairs by key, removes duplicates and returns the keys
+    static std::vector<K> SortUnique(std::vector<std::pair<K, V>> &pairs)
+    {
+        std::stable_sort(pairs.begin(), pairs.end(), [](const std::pair<K, V> &a, const std::pair<K, V> &b)
+        {
+            return KeyLess(a.first, b.first);
+        });
+
+        pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const std::pair<K, V> &a, const std::pair<K, V> &b)
+        {
+            return KeyEqual(a.first, b.first);
+        }), pairs.end());
+
+        std::vector<K> keys(pairs.size());
+        for (size_t i=0; i<pairs.size(); i++)
+            keys[i] = pairs[i].first;
+        return keys;
+    }
+
+    static std::vector<V> ValueColumn(std::vector<std::pair<K, V>> &&pairs)
+    {
+        std::vector<V> values;
+        values.reserve(pairs.size());
+        for (auto &p : pairs)
+            values.push_back(std::move(p.second));
+        return values;
+    }
+
+private:
+    std::unique_ptr<const std::vector<K>> Keys;
+    std::vector<V>                        Values;
+    std::unique_ptr<const Index>          Idx; // null for an empty map
+};
+
+// layouts supported by the Eytzinger search
+enum class EytzingerLayout
+{
+    Global,     // all values form a single Eytzinger tree
+    LutBuckets  // each LUT interval is stored as its own Eytzinger tree
+};
+
+// binary search over values re-laid in breadth-first (Eytzinger) order.
+// the first levels of the tree are shared by all searches and stay in
+// cache, and the children of a node are adjacent in memory, so they can be
+// prefetched a few levels ahead. lookups return the index in the sorted
+// input, so results match the ones of SearchPod32.
+template<class T, size_t LUT_BITS> class EytzingerPod32
+{
+public:
+    EytzingerPod32(const std::vector<T> &vals, EytzingerLayout layout) :
+        Layout(layout)
+    {
+        // 1-based trees: element 0 is padding, so that interval [start, end]
+        // of the sorted values is stored at Tree[start+1] ... Tree[end+1]
+        Tree.resize(vals.size()+1);
+
+        if (Layout == EytzingerLayout::Global)
+            Build(vals.data(), &Tree[0], vals.size(), 0, 1);
+        else
+        {
+            // only the bucketed layout needs the LUT
+            Index = std::unique_ptr<SearchPod32<T, LUT_BITS>>(new SearchPod32<T, LUT_BITS>(vals));
+
+            for (size_t i=0; i<Index->NumLutIntervals(); i++)
+            {
+                ssize_t start, end;
+                Index->LutIntervalAt(i, start, end);
+                Build(&vals[start], &Tree[start], end-start+1, 0, 1);
+            }
+        }
+    }
+
+    ssize_t Search(T key) const
+    {
+        ssize_t start = 0, end = (ssize_t)Tree.size()-2;
+
+        if (Layout == EytzingerLayout::LutBuckets && !Index->LutInterval(key, start, end))
+            return -1;
+
+        const ssize_t rank = SearchTree(&Tree[start], end-start+1, key);
+        return (rank < 0 ? -1 : start+rank);
+    }
+
+private:
+    // fills the tree with n values in-order; returns the next value to use
+    static size_t Build(const T *sorted, T *tree, ssize_t n, size_t i, ssize_t k)
+    {
+        if (k <= n)
+        {
+            i = Build(sorted, tree, n, i, 2*k);
+            tree[k] = sorted[i++];
+            i = Build(sorted, tree, n, i, 2*k+1);
+        }
+
+        return i;
+    }
+
+    // returns the sorted rank of the key's first occurrence or -1
+    static ssize_t SearchTree(const T *tree, ssize_t n, T key)
+    {
+        size_t k = 1;
+
+        while ((ssize_t)k <= n)
+        {
+            __builtin_prefetch(tree+16*k); // 16 children of the grand-grand-children
+            k = 2*k+KeyLess(tree[k], key);
+        }
+
+        // the lower bound is the last node where the search went left,
+        // i.e. remove trailing ones and the final zero of the path
+        k >>= __builtin_ffsll(~k);
+        return (k != 0 && KeyEqual(tree[k], key) ? Rank(k, n) : -1);
+    }
+
+    // in-order rank of the k-th node of a tree with n nodes
+    static size_t Rank(size_t k, size_t n)
+    {
+        const size_t h = Log2(n);
+        const size_t d = Log2(k);
+
+        // rank if the last level was complete: every last level
+        // node p (0-based) precedes 2p nodes in in-order
+        const size_t rank = ((2*(k-((size_t)1<<d))+1)<<(h-d))-1;
+
+        // subtract the missing last level nodes preceding the node
+        const size_t lastLevel = n+1-((size_t)1<<h);
+        const size_t lastBefore = (rank+1)>>1;
+        return rank-(lastBefore > lastLevel ? lastBefore-lastLevel : 0);
+    }
+
+    static size_t Log2(size_t x)
+    {
+        return 63-__builtin_clzll(x);
+    }
+
+private:
+    std::unique_ptr<SearchPod32<T, LUT_BITS>> Index; // null for the global layout
+    std::vector<T>                            Tree;
+    EytzingerLayout                           Layout;
+};
+
+// static B+tree (S-tree) with 16 keys per node, i.e. one cache line per
+// node. nodes are compared against the key with one (AVX-512) or two
+// (AVX2) SIMD compares, so a lookup touches about log16(N) cache lines.
+// keys are stored as their mapped values with the sign bit flipped, so
+// that a single signed 32-bit compare kernel serves all supported types.
+template<class T> class STreePod32
+{
+public:
+    STreePod32(const std::vector<T> &vals) :
+        NumVals(vals.size())
+    {
+        static_assert(INJECTIVE_KEY_MAPPING<T>, "S-tree compares mapped keys: requires a one-to-one key mapping");
+
+        // layer offsets, starting with the leaves which hold all keys in order
+        size_t n = NumVals;
+        LayerOffsets.push_back(0);
+
+        while (true)
+        {
+            LayerOffsets.push_back(LayerOffsets.back()+NumNodes(n)*NODE_KEYS);
+            if (n <= NODE_KEYS)
+                break;
+
+            n = NumNodes(NumNodes(n), NODE_KEYS+1)*NODE_KEYS; // inner nodes have one child more than keys
+        }
+
+        // align the tree to cache lines
+        const size_t numKeys = LayerOffsets.back();
+        Storage.resize(numKeys+NODE_KEYS);
+        TreeOffset = (64-((uintptr_t)Storage.data()&63))/sizeof(int32_t)%NODE_KEYS;
+        int32_t *tree = &Storage[TreeOffset];
+
+        std::fill(tree, tree+numKeys, std::numeric_limits<int32_t>::max());
+        for (size_t i=0; i<NumVals; i++)
+            tree[i] = MapKey(vals[i]);
+
+        // the j-th key of an inner node is the smallest key of its
+        // (j+1)-th child's subtree, i.e. of that subtree's leftmost leaf
+        for (size_t h=1; h<LayerOffsets.size()-1; h++)
+        {
+            for (size_t i=0; i<LayerOffsets[h+1]-LayerOffsets[h]; i++)
+            {
+                size_t node = (i/NODE_KEYS)*(NODE_KEYS+1)+i%NODE_KEYS+1;
+                for (size_t l=1; l<h; l++)
+                    node *= NODE_KEYS+1;
+
+                tree[LayerOffsets[h]+i] = (node*NODE_KEYS < NumVals ? tree[node*NODE_KEYS] : std::numeric_limits<int32_t>::max());
+            }
+        }
+    }
+
+    ssize_t Search(T key) const
+    {
+        const int32_t *tree = &Storage[TreeOffset];
+        const int32_t mappedKey = MapKey(key);
+        size_t k = 0; // offset of the current node's first key in its layer
+
+        for (size_t h=LayerOffsets.size()-2; h>0; h--)
+            k = k*(NODE_KEYS+1)+CountLess(tree+LayerOffsets[h]+k, mappedKey)*NODE_KEYS;
+
+        // leaves are stored in order => offset into leaf layer is the sorted index
+        const size_t idx = k+CountLess(tree+k, mappedKey);
+        return (idx < NumVals && tree[idx] == mappedKey ? (ssize_t)idx : -1);
+    }
+
+private:
+    static const size_t NODE_KEYS = 16;
+
+    static int32_t MapKey(T val)
+    {
+        return (int32_t)(MapValue<T>(val)^0x80000000);
+    }
+
+    static size_t NumNodes(size_t numKeys, size_t keysPerNode=NODE_KEYS)
+    {
+        return (numKeys+keysPerNode-1)/keysPerNode;
+    }
+
+    // number of keys in the node smaller than the key
+    static size_t CountLess(const int32_t *node, int32_t key)
+    {
+#if defined(__AVX512F__)
+        const __m512i keys = _mm512_set1_epi32(key);
+        const __m512i nodeKeys = _mm512_load_si512((const __m512i *)node);
+        return __builtin_popcount(_mm512_cmpgt_epi32_mask(keys, nodeKeys));
+#elif defined(__AVX2__)
+        const __m256i keys = _mm256_set1_epi32(key);
+        const __m256i lo = _mm256_cmpgt_epi32(keys, _mm256_load_si256((const __m256i *)node));
+        const __m256i hi = _mm256_cmpgt_epi32(keys, _mm256_load_si256((const __m256i *)(node+8)));
+        const uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(lo))|((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(hi))<<8);
+        return __builtin_popcount(mask);
+#else
+        size_t count = 0;
+        for (size_t i=0; i<NODE_KEYS; i++)
+            count += (node[i] < key);
+        return count;
+#endif
+    }
+
+private:
+    std::vector<int32_t> Storage;
+    size_t               TreeOffset;
+    std::vector<size_t>  LayerOffsets; // leaves first, plus end of last layer
+    size_t               NumVals;
+};
+
+// two-stage recursive model index (RMI). a root linear model maps the
+// key to one of the leaf linear models, which predicts the key's index.
+// each leaf model stores the maximum error of its predictions over the
+// values it covers, so the last-mile binary search is bounded by these
+// error bounds. in contrast to the LUT, which is a piecewise-constant
+// model of the values' CDF, the models are piecewise-linear.
+template<class T> class RmiPod32
+{
+public:
+    RmiPod32(const std::vector<T> &vals, size_t numModels) :
+        Vals(vals),
+        Models(numModels)
+    {
+        assert(numModels > 0 && !vals.empty());
+        InitRootModel();
+        InitLeafModels();
+    }
+
+    ssize_t Search(T key) const
+    {
+        const double x = (double)key;
+        const Model &m = Models[PredictModel(x)];
+        const ssize_t pos = Predict(m, x);
+        return BinarySearch(Vals, std::max(pos-(ssize_t)m.ErrLow, (ssize_t)0), std::min(pos+(ssize_t)m.ErrHigh, (ssize_t)Vals.size()-1), key);
+    }
+
+    size_t MemoryFootprint() const
+    {
+        return sizeof(RootSlope)+sizeof(RootIntercept)+Models.size()*sizeof(Model);
+    }
+
+    static size_t ModelFootprint()
+    {
+        return sizeof(Model);
+    }
+
+private:
+    struct Model
+    {
+        double   Slope;
+        double   Intercept;
+        uint32_t ErrLow;  // maximum over-prediction
+        uint32_t ErrHigh; // maximum under-prediction
+    };
+
+    size_t PredictModel(double x) const
+    {
+        // compare before converting, keys far outside the data set overflow integers
+        const double m = RootSlope*x+RootIntercept;
+        return (m <= 0.0 ? 0 : (m >= (double)(Models.size()-1) ? Models.size()-1 : (size_t)m));
+    }
+
+    ssize_t Predict(const Model &m, double x) const
+    {
+        const double pos = m.Slope*x+m.Intercept;
+        return (pos <= 0.0 ? 0 : (pos >= (double)(Vals.size()-1) ? (ssize_t)Vals.size()-1 : (ssize_t)pos));
+    }
+
+    // least squares fit of key => model index, i.e. of the scaled CDF
+    void InitRootModel()
+    {
+        const double n = (double)Vals.size();
+        double meanX = 0.0;
+
+        for (const auto &v : Vals)
+            meanX += (double)v/n;
+
+        const double meanY = (n-1.0)/2.0;
+        double covXY = 0.0, varX = 0.0;
+
+        for (size_t i=0; i<Vals.size(); i++)
+        {
+            const double dx = (double)Vals[i]-meanX;
+            covXY += dx*((double)i-meanY);
+            varX += dx*dx;
+        }
+
+        const double scale = (double)Models.size()/n;
+        RootSlope = (varX > 0.0 ? covXY/varX*scale : 0.0);
+        RootIntercept = (meanY-(varX > 0.0 ? covXY/varX : 0.0)*meanX)*scale;
+    }
+
+    // the root model is monotone, so each leaf model covers a contiguous
+    // range of values. the leaf models are lines through the first and
+    // the last value of their range.
+    void InitLeafModels()
+    {
+        size_t first = 0;
+
+        for (size_t m=0; m<Models.size(); m++)
+        {
+            size_t last = first;
+            while (last < Vals.size() && PredictModel((double)Vals[last]) == m)
+                last++;
+
+            Model &model = Models[m];
+            model.Slope = 0.0;
+            model.Intercept = (double)std::min(first, Vals.size()-1);
+            model.ErrLow = model.ErrHigh = 0;
+
+            if (last-first > 1 && (double)Vals[last-1] > (double)Vals[first])
+            {
+                model.Slope = (double)(last-1-first)/((double)Vals[last-1]-(double)Vals[first]);
+                model.Intercept = (double)first-model.Slope*(double)Vals[first];
+            }
+
+            for (size_t i=first; i<last; i++)
+            {
+                // only the first occurence of a key has to be in the search bounds
+                if (i > first && KeyEqual(Vals[i], Vals[i-1]))
+                    continue;
+
+                const ssize_t pos = Predict(model, (double)Vals[i]);
+                model.ErrLow = std::max(model.ErrLow, (uint32_t)std::max(pos-(ssize_t)i, (ssize_t)0));
+                model.ErrHigh = std::max(model.ErrHigh, (uint32_t)std::max((ssize_t)i-pos, (ssize_t)0));
+            }
+
+            first = last;
+        }
+    }
+
+private:
+    const std::vector<T> & Vals;
+    double                 RootSlope;
+    double                 RootIntercept;
+    std::vector<Model>     Models;
+};
+
+// RadixSpline: a linear spline through (mapped key, index) points which
+// approximates the values' CDF with an error of at most maxError, plus
+// a radix table over the spline knots. a lookup does a radix step with
+// the key's top bits, a binary search over the few knots of the radix
+// entry, interpolates between the two surrounding knots and finally
+// binary searches +/- maxError values around the interpolated index.
+// the last-mile search is bounded independent of the data distribution,
+// while the table indexes the much fewer knots instead of the values.
+template<class T, size_t RADIX_BITS> class RadixSplinePod32
+{
+public:
+    RadixSplinePod32(const std::vector<T> &vals, size_t maxError) :
+        Vals(vals),
+        MaxError(maxError)
+    {
+        static_assert(RADIX_BITS > 0 && RADIX_BITS < 32, "invalid radix table size");
+        static_assert(INJECTIVE_KEY_MAPPING<T>, "RadixSpline compares mapped keys: requires a one-to-one key mapping");
+        assert(!vals.empty());
+        InitSpline();
+        InitRadixTable();
+    }
+
+    ssize_t Search(T key) const
+    {
+        const uint32_t mappedKey = MapValue<T>(key);
+        if (mappedKey < KnotKeys.front() || mappedKey > KnotKeys.back())
+            return -1;
+
+        // first knot >= key among the knots with the key's prefix
+        const size_t prefix = mappedKey>>(32-RADIX_BITS);
+        const auto knot = std::lower_bound(KnotKeys.begin()+RadixTable[prefix], KnotKeys.begin()+RadixTable[prefix+1], mappedKey);
+        const size_t j = knot-KnotKeys.begin();
+
+        if (*knot == mappedKey)
+            return BinarySearch(Vals, KnotPositions[j], KnotPositions[j], key);
+
+        // interpolate between knots j-1 and j
+        const double t = (double)(mappedKey-KnotKeys[j-1])/(double)(KnotKeys[j]-KnotKeys[j-1]);
+        const ssize_t pos = (ssize_t)KnotPositions[j-1]+(ssize_t)(t*(double)(KnotPositions[j]-KnotPositions[j-1]));
+        const ssize_t bound = (ssize_t)MaxError+1; // +1 compensates rounding
+        return BinarySearch(Vals, std::max(pos-bound, (ssize_t)0), std::min(pos+bound, (ssize_t)Vals.size()-1), key);
+    }
+
+    size_t NumKnots() const
+    {
+        return KnotKeys.size();
+    }
+
+    size_t MemoryFootprint() const
+    {
+        return RadixTable.size()*sizeof(RadixTable[0])+KnotKeys.size()*(sizeof(KnotKeys[0])+sizeof(KnotPositions[0]));
+    }
+
+private:
+    void AddKnot(uint32_t key, size_t pos)
+    {
+        KnotKeys.push_back(key);
+        KnotPositions.push_back(pos);
+    }
+
+    // greedy spline corridor: extends the current segment as long as a
+    // line from its first knot can pass all values' positions +/- maxError
+    void InitSpline()
+    {
+        const double maxError = (double)MaxError;
+        double minSlope = 0.0, maxSlope = std::numeric_limits<double>::max();
+        uint32_t prevKey = MapValue<T>(Vals[0]);
+        size_t prevPos = 0;
+
+        AddKnot(prevKey, prevPos);
+
+        for (size_t i=1; i<Vals.size(); i++)
+        {
+            const uint32_t key = MapValue<T>(Vals[i]);
+            if (key == prevKey) // only first occurences must be found
+                continue;
+
+            const double dx = (double)(key-KnotKeys.back());
+            const double dy = (double)(i-KnotPositions.back());
+
+            if (dy < minSlope*dx || dy > maxSlope*dx)
+            {
+                // not in corridor => previous value ends segment
+                AddKnot(prevKey, prevPos);
+                const double newDx = (double)(key-prevKey);
+                const double newDy = (double)(i-prevPos);
+                minSlope = (newDy-maxError)/newDx;
+                maxSlope = (newDy+maxError)/newDx;
+            }
+            else
+            {
+                minSlope = std::max(minSlope, (dy-maxError)/dx);
+                maxSlope = std::min(maxSlope, (dy+maxError)/dx);
+            }
+
+            prevKey = key;
+            prevPos = i;
+        }
+
+        if (KnotKeys.back() != prevKey)
+            AddKnot(prevKey, prevPos);
+    }
+
+    // RadixTable[p] = index of first knot with a prefix >= p
+    void InitRadixTable()
+    {
+        RadixTable.resize(((size_t)1<<RADIX_BITS)+1);
+        size_t knot = 0;
+
+        for (size_t p=0; p<RadixTable.size(); p++)
+        {
+            while (knot < KnotKeys.size() && (KnotKeys[knot]>>(32-RADIX_BITS)) < p)
+                knot++;
+            RadixTable[p] = (uint32_t)knot;
+        }
+    }
+
+private:
+    const std::vector<T> & Vals;
+    size_t                 MaxError;
+    std::vector<uint32_t>  KnotKeys;
+    std::vector<size_t>    KnotPositions;
+    std::vector<uint32_t>  RadixTable;
+};
+
+// counts the calling thread's cache misses using perf events. only
+// available on Linux and if perf events are permitted; otherwise
+// Stop() returns -1.
+class CacheMissCounter
+{
+public:
+    // counts the misses of the calling thread and of the given threads,
+    // e.g. the workers of a WorkStealingPool, which do the actual work
+    // while the calling thread waits
+    explicit CacheMissCounter(const std::vector<int> &threadIds={})
+    {
+#if defined(__linux__)
+        Open(0);
+        for (const int tid : threadIds)
+            Open(tid);
+#else
+        (void)threadIds;
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#if defined(__linux__)
+        for (const int fd : Fds)
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+
+    // sum over all threads, -1 if any of them couldn't be counted
+    int64_t Stop()
+    {
+        int64_t misses = -1;
+#if defined(__linux__)
+        misses = 0;
+        for (const int fd : Fds)
+        {
+            int64_t threadMisses;
+            if (fd < 0 || read(fd, &threadMisses, sizeof(threadMisses)) != sizeof(threadMisses))
+                return -1;
+            misses += threadMisses;
+        }
+#endif
+        return misses;
+    }
+
+private:
+#if defined(__linux__)
+    void Open(int tid)
+    {
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        const int fd = (int)syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0);
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        Fds.push_back(fd);
+    }
+#endif
+
+private:
+    std::vector<int> Fds;
+};
+
+template<class DURATION> void PrintBenchmarkResult(size_t res, const DURATION &elapsed, size_t numKeys, int64_t cacheMisses)
+{
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    const auto secs = std::chrono::duration<double>(elapsed).count(); // direct LUT searches can take less than 1 ms
+    const auto searchesPerSec = (size_t)((double)numKeys/secs);
+
+    std::cout << "Result: " << res << std::endl;
+    std::cout << "Elapsed time: " << ms << " ms = " << (float)ms/1000.0f << " secs" << std::endl;
+    std::cout << "Searches/sec: " << searchesPerSec << " = " << (float)searchesPerSec/1000.0f/1000.0f << " m" << std::endl;
+    if (cacheMisses >= 0)
+        std::cout << "Cache misses/search: " << (float)cacheMisses/(float)numKeys << std::endl;
+    std::cout << std::endl;
+}
+
+template<class T, class SEARCH, class ALGO_FUNC> void BenchmarkAlgo(const std::vector<T> &vals, const std::vector<T> &keys, const std::string &algoName, const ALGO_FUNC &algoFunc, const SEARCH &s)
+{
+    std::cout << "Running: '" << algoName << "':" << std::endl;
+    std::cout << "---------------------------------------" << std::endl;
+
+    CacheMissCounter cacheMisses;
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t res = 0;
+
+    for (size_t i=0; i<keys.size(); i++)
+    {
+        const auto idx = (s.*algoFunc)(keys[i]);
+        assert(vals[idx] == keys[i]);
+        res += idx; // that loop doesn't get optimized out
+    }
+
+    const auto elapsed = std::chrono::high_resolution_clock::now()-start;
+    PrintBenchmarkResult(res, elapsed, keys.size(), cacheMisses.Stop());
 }
 
-template<> uint32_t MapValue<uint32_t>(uint32_t val) // 32-bit unsigned int
+// benchmarks search functions which resolve a whole batch of keys at once
+// threadIds are the threads doing the searches besides the calling one
+template<class T, class BATCH_FUNC> void BenchmarkBatch(const std::vector<T> &vals, const std::vector<T> &keys, const std::string &algoName, const BATCH_FUNC &batchFunc, const std::vector<int> &threadIds={})
 {
-    return val; // no bit-twiddling required, just forward
+    std::cout << "Running: '" << algoName << "':" << std::endl;
+    std::cout << "---------------------------------------" << std::endl;
+
+    std::vector<ssize_t> idxs(keys.size());
+    CacheMissCounter cacheMisses(threadIds);
+    const auto start = std::chrono::high_resolution_clock::now();
+    batchFunc(std::span<const T>(keys), std::span<ssize_t>(idxs));
+    const auto elapsed = std::chrono::high_resolution_clock::now()-start;
+    const int64_t numCacheMisses = cacheMisses.Stop();
+    size_t res = 0;
+
+    for (size_t i=0; i<keys.size(); i++)
+    {
+        assert(vals[idxs[i]] == keys[i]);
+        res += idxs[i];
+    }
+
+    PrintBenchmarkResult(res, elapsed, keys.size(), numCacheMisses);
 }
 
-template<> uint32_t MapValue<int32_t>(int32_t val) // 32-bit signed int
+// benchmarks queries which don't return the index of the key, e.g. ranges.
+// queryFunc(key) checks its result itself and returns a number to sum up.
+template<class T, class QUERY_FUNC> void BenchmarkQuery(const std::vector<T> &keys, const std::string &algoName, const QUERY_FUNC &queryFunc)
 {
-    return (uint32_t)val^0x80000000; // flip sign bit
+    std::cout << "Running: '" << algoName << "':" << std::endl;
+    std::cout << "---------------------------------------" << std::endl;
+
+    CacheMissCounter cacheMisses;
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t res = 0;
+
+    for (size_t i=0; i<keys.size(); i++)
+        res += queryFunc(keys[i]); // that loop doesn't get optimized out
+
+    const auto elapsed = std::chrono::high_resolution_clock::now()-start;
+    PrintBenchmarkResult(res, elapsed, keys.size(), cacheMisses.Stop());
 }
 
-// taken from Michael Herf's article on Stereopsis
-template<> uint32_t MapValue<float>(float val) // 32-bit float
+// smallest key bigger than val, if there's one
+template<class T> T NextKey(T val)
 {
-    // 1) flip sign bit
-    // 2) if sign bit was set flip all other bits as well
-    const uint32_t cv = (uint32_t &)val;
-    const uint32_t mask = (-(int32_t)(cv>>31))|0x80000000;
-    return cv^mask;
+    if constexpr (std::is_floating_point_v<T>)
+        return std::nextafter(val, std::numeric_limits<T>::infinity());
+    else
+        return (val < std::numeric_limits<T>::max() ? val+1 : val);
 }
 
-// LUT optimized binary search implementation for 32-bit POD types
-template<class T, size_t LUT_BITS> class SearchPod32
+// generates the data set of a benchmark: NUM_VALS values drawn with
+// distVals, sorted like the engines and the std baselines compare, and
+// the keys to look up, which are drawn from the values
+template<class T, size_t NUM_VALS, class RND_GEN, class RND_DIST_VALS> void GenerateDataSet(const std::string &typeDescr, std::vector<T> &vals, std::vector<T> &keys, RND_GEN &gen, RND_DIST_VALS &distVals)
 {
-public:
-    SearchPod32(const std::vector<T> &vals) :
-        Vals(vals)
+    const size_t NUM_KEYS = 10000000;
+
+    vals.resize(NUM_VALS);
+    keys.resize(NUM_KEYS);
+    std::uniform_int_distribution<size_t> distKeys(0, vals.size()-1);
+
+    std::cout << "Benchmarking: " << typeDescr << std::endl;
+    std::cout << "Generating data set..." << std::endl;
+
+    for (auto &v : vals)
+        v = distVals(gen);
+    for (auto &k : keys)
+        k = vals[distKeys(gen)];
+
+    // sort so that binary search is applicable
+    std::cout << "Pre-sorting data set..." << std::endl << std::endl;
+    std::sort(vals.begin(), vals.end(), [](const T &a, const T &b)
     {
-        static_assert(LUT_BITS > 0 && LUT_BITS < 32, "invalid binary search LUT size");
-        InitLut();
-    }
+        return KeyLess(a, b);
+    });
+}
 
-    ssize_t StdBinarySearch(T key) const
+template<class T, size_t LUT_BITS, class RND_DIST_VALS> void Benchmark(const std::string &typeDescr, RND_DIST_VALS &distVals)
+{
+    std::vector<T> vals, keys;
+    std::mt19937 gen(303);
+    GenerateDataSet<T, 1000000000>(typeDescr, vals, keys, gen, distVals);
+
+    std::vector<T> missKeys(keys.size());
+    std::uniform_int_distribution<size_t> distKeys(0, vals.size()-1);
+
+    // the std baselines compare like the engines
+    const auto keyLess = [](T a, T b)
     {
-        const auto iter = std::lower_bound(Vals.begin(), Vals.end(), key);
-        return (iter != Vals.end() && *iter == key ? std::distance(Vals.begin(), iter) : -1);
-    }
+        return KeyLess(a, b);
+    };
 
-    ssize_t MyBinarySearch(T key) const
+    // keys which aren't contained: the next representable key after a
+    // random value, if it's still smaller than the following value.
+    // drawing random keys until one is missing doesn't work for floats,
+    // as the distribution only produces values on a coarse grid, which
+    // the data set covers almost completely.
+    for (auto &k : missKeys)
     {
-        return BinarySearch(0, (ssize_t)Vals.size()-1, key);
+        while (true)
+        {
+            const size_t idx = distKeys(gen);
+            const T next = NextKey(vals[idx]);
+            if (KeyLess(vals[idx], next) && (idx+1 == vals.size() || KeyLess(next, vals[idx+1])))
+            {
+                k = next;
+                break;
+            }
+        }
     }
 
-    ssize_t LutBinarySearch(T key) const
+    SearchPod32<T, LUT_BITS> s(vals);
+    std::cout << "Look-up table footprint: " << s.MemoryFootprint()/1024 << " KB" << std::endl << std::endl;
+    BenchmarkAlgo<T>(vals, keys, "My binary search", &SearchPod32<T, LUT_BITS>::MyBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Standard binary search", &SearchPod32<T, LUT_BITS>::StdBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Lookup binary search", &SearchPod32<T, LUT_BITS>::LutBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Branchless lookup binary search", &SearchPod32<T, LUT_BITS>::LutBranchlessSearch, s);
+    s.TuneScanThreshold();
+    std::cout << "Linear scan threshold: " << s.ScanThreshold() << " values" << std::endl;
+    BenchmarkAlgo<T>(vals, keys, "Hybrid lookup search", &SearchPod32<T, LUT_BITS>::LutHybridSearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Interpolation lookup search", &SearchPod32<T, LUT_BITS>::LutInterpolationSearch, s);
+    std::cout << "Sub-LUTs: " << s.NumSubLuts() << ", worst-case probes: " << s.MaxProbes() << std::endl;
+    BenchmarkAlgo<T>(vals, keys, "Two-level lookup binary search", &SearchPod32<T, LUT_BITS>::LutTwoLevelSearch, s);
+
+    for (const auto &workload : {std::make_pair(&keys, "hits"), std::make_pair(&missKeys, "misses")})
     {
-        const auto mappedKey = MapValue<T>(key);
-        const auto lutIdx = mappedKey>>(32-LUT_BITS);
-        const auto start = Lut[lutIdx];
+        const auto &wkeys = *workload.first;
+        const std::string descr = std::string(" (")+workload.second+")";
+        const auto stdLowerBound = [&](T key) -> size_t
+        {
+            return std::lower_bound(vals.begin(), vals.end(), key, keyLess)-vals.begin();
+        };
+        const auto stdUpperBound = [&](T key) -> size_t
+        {
+            return std::upper_bound(vals.begin(), vals.end(), key, keyLess)-vals.begin();
+        };
 
-        // interval end of i-th LUT entry = interval start of (i+1)th LUT entry - 1.
-        // however, all LUT remaining LUT entries map to the last valid interval
-        // start => interval end < interval start => just use number of values
-        const auto end = (lutIdx+1 >= LutEnd ? Vals.size()-1 : Lut[lutIdx+1]-1);
-        return BinarySearch(start, end, key);
-    }
+        BenchmarkQuery(wkeys, "Standard lower bound"+descr, stdLowerBound);
+        BenchmarkQuery(wkeys, "Lookup lower bound"+descr, [&](T key)
+        {
+            const size_t idx = s.LowerBound(key);
+            assert(idx == stdLowerBound(key));
+            return idx;
+        });
 
-private:
-    ssize_t BinarySearch(ssize_t left, ssize_t right, T key) const
-    {
-        /*
-        size_t __len = right-left;
-        size_t __first = left;
+        BenchmarkQuery(wkeys, "Standard upper bound"+descr, stdUpperBound);
+        BenchmarkQuery(wkeys, "Lookup upper bound"+descr, [&](T key)
+        {
+            const size_t idx = s.UpperBound(key);
+            assert(idx == stdUpperBound(key));
+            return idx;
+        });
 
-        while (__len > 0)
+        BenchmarkQuery(wkeys, "Standard equal range"+descr, [&](T key)
         {
-            size_t __half = __len >> 1;
-            size_t __middle = __first+__half;
+            const auto range = std::equal_range(vals.begin(), vals.end(), key, keyLess);
+            return range.second-range.first;
+        });
 
-            if (Vals[__middle] < key)
-            {
-                __first = __middle;
-                ++__first;
+        BenchmarkQuery(wkeys, "Lookup equal range"+descr, [&](T key)
+        {
+            const auto range = s.EqualRange(key);
+            assert(range.first == stdLowerBound(key) && range.second == stdUpperBound(key));
+            return range.second-range.first;
+        });
 
-                __len = __len - __half - 1;
-            }
-            else
-                __len = __half;
-        }
+        BenchmarkQuery(wkeys, "Lookup count"+descr, [&](T key)
+        {
+            return s.Count(key);
+        });
 
-        return __first;
-        */
+        BenchmarkQuery(wkeys, "Lookup rank"+descr, [&](T key)
+        {
+            return s.Rank(key);
+        });
 
-        while (left < right)
+        BenchmarkQuery(wkeys, "Lookup predecessor"+descr, [&](T key)
         {
-            const auto mid = left+((right-left)>>1); // avoids overflow
-            assert(mid < right); // interval must be reduced in each iteration
-            const auto valMid = Vals[mid];
+            const ssize_t idx = s.Predecessor(key);
+            assert(idx == (ssize_t)stdLowerBound(key)-1);
+            return idx+1;
+        });
 
-            // no early exit so that always the occurence
-            // of the key with the lowest index is found
-            if (valMid < key)
-                left = mid+1;
-            else
-                right = mid;
-        }
+        BenchmarkQuery(wkeys, "Lookup successor"+descr, [&](T key)
+        {
+            const ssize_t idx = s.Successor(key);
+            assert(idx < 0 || (size_t)idx == stdUpperBound(key));
+            return idx+1;
+        });
+    }
 
-        assert(left == right);
-        return (Vals[left] == key ? left : -1);
+    // range scans over [lo, hi] with about RANGE_LEN values each. the
+    // values are summed up and counted against the median as predicate.
+    const size_t RANGE_LEN = 64;
+    const T median = vals[vals.size()/2];
+    std::vector<std::pair<T, T>> ranges(keys.size());
+    for (size_t i=0; i<ranges.size(); i++)
+    {
+        const size_t idx = distKeys(gen);
+        ranges[i] = std::make_pair(vals[idx], vals[std::min(idx+RANGE_LEN, vals.size()-1)]);
     }
 
-    void InitLut()
+    const auto belowMedian = [median](T v) {return KeyLess(v, median);};
+    BenchmarkQuery(ranges, "Standard range scan", [&](const std::pair<T, T> &range)
     {
-        // fill look-up-table
-        Lut.resize((1<<LUT_BITS)+1); // one additional element to avoid condition in interval end computation
+        const auto first = std::lower_bound(vals.begin(), vals.end(), range.first, keyLess);
+        const auto last = std::upper_bound(first, vals.end(), range.second, keyLess);
+        ScanSumType<T> sum = 0;
+        size_t count = 0;
+        for (auto it=first; it!=last; it++)
+        {
+            sum += *it;
+            count += (belowMedian(*it) ? 1 : 0);
+        }
 
-        size_t thresh = 0;
-        size_t last = 0;
+        return count+(sum != 0 ? 1 : 0);
+    });
+
+    BenchmarkQuery(ranges, "Lookup range scan", [&](const std::pair<T, T> &range)
+    {
+        const auto scan = s.Scan(range.first, range.second);
+        const auto sum = ScanSum(scan);
+        const size_t count = ScanCountIf(scan, belowMedian);
+        assert(scan.data() == &*std::lower_bound(vals.begin(), vals.end(), range.first, keyLess));
+        assert(count == (size_t)std::count_if(scan.begin(), scan.end(), belowMedian));
+        return count+(sum != 0 ? 1 : 0);
+    });
 
-        for (ssize_t i=0; i<(ssize_t)Vals.size()-1; i++)
+    for (size_t groupSize : {4, 8, 16, 32, 64})
+    {
+        BenchmarkBatch(vals, keys, "Batched lookup search (group size "+std::to_string(groupSize)+")", [&](std::span<const T> keys, std::span<ssize_t> out)
         {
-            const uint32_t mappedNextVal = MapValue<T>(Vals[i+1]);
-            const uint32_t nextThresh = mappedNextVal>>(32-LUT_BITS);
-            Lut[thresh] = last;
+            s.LutBinarySearchBatch(keys, out, groupSize);
+        });
+    }
 
-            if (nextThresh > thresh)
-            {
-                last = i+1;
-                for (size_t j=thresh+1; j<=nextThresh; j++)
-                    Lut[j] = last;
-            }
+    for (size_t numInFlight : {8, 16, 32})
+    {
+        BenchmarkBatch(vals, keys, "Interleaved coroutine lookup search ("+std::to_string(numInFlight)+" in flight)", [&](std::span<const T> keys, std::span<ssize_t> out)
+        {
+            RunInterleaved(keys, out, numInFlight, [&](T key) { return s.LutBinarySearchTask(key); });
+        });
+    }
 
-            thresh = nextThresh;
-        }
+    std::vector<T> sortedKeys(keys);
+    std::sort(sortedKeys.begin(), sortedKeys.end(), keyLess);
+    BenchmarkAlgo<T>(vals, sortedKeys, "Lookup binary search (sorted keys)", &SearchPod32<T, LUT_BITS>::LutBinarySearch, s);
+    BenchmarkBatch(vals, sortedKeys, "Sorted batch lookup search (sorted keys)", [&](std::span<const T> keys, std::span<ssize_t> out)
+    {
+        s.LutSortedBatchSearch(keys, out);
+    });
 
-        // set remaining thresholds that couldn't be found
-        for (size_t i=thresh; i<Lut.size()-1; i++)
-            Lut[i] = last;
+    // 1, 2, 4, ... threads up to the number of hardware threads
+    std::vector<size_t> threadCounts;
+    const size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t numThreads=1; numThreads<maxThreads; numThreads*=2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(maxThreads);
 
-        // remember last end threshold index, because the interval
-        // end of all values mapping to an entry bigger than
-        // that have to be handled differently
-        LutEnd = thresh;
+    for (size_t numThreads : threadCounts)
+    {
+        WorkStealingPool pool(numThreads);
+        BenchmarkBatch(vals, keys, "Parallel batched lookup search ("+std::to_string(numThreads)+" threads)", [&](std::span<const T> keys, std::span<ssize_t> out)
+        {
+            ParallelBatchSearch(pool, keys, out, 16384, [&](std::span<const T> chunkKeys, std::span<ssize_t> chunkOut)
+            {
+                s.LutBinarySearchBatch(chunkKeys, chunkOut);
+            });
+        }, pool.ThreadIds());
+    }
 
-        /*
-        for (auto v : Lut)
-            std::cout << v.first << ", " << v.second << std::endl;
-        */
+    // the Eytzinger trees are copies of the data set, so only keep one alive at a time
+    {
+        const EytzingerPod32<T, LUT_BITS> e(vals, EytzingerLayout::Global);
+        BenchmarkAlgo<T>(vals, keys, "Eytzinger search", &EytzingerPod32<T, LUT_BITS>::Search, e);
+    }
+    {
+        const EytzingerPod32<T, LUT_BITS> e(vals, EytzingerLayout::LutBuckets);
+        BenchmarkAlgo<T>(vals, keys, "Lookup Eytzinger search", &EytzingerPod32<T, LUT_BITS>::Search, e);
+    }
+    {
+        const STreePod32<T> t(vals);
+        BenchmarkAlgo<T>(vals, keys, "S-tree search", &STreePod32<T>::Search, t);
+    }
+    {
+        // same memory budget as the look-up table
+        const RmiPod32<T> r(vals, std::max(s.MemoryFootprint()/RmiPod32<T>::ModelFootprint(), (size_t)1));
+        std::cout << "RMI footprint: " << r.MemoryFootprint()/1024 << " KB" << std::endl << std::endl;
+        BenchmarkAlgo<T>(vals, keys, "RMI search", &RmiPod32<T>::Search, r);
     }
 
-private:
-    std::vector<size_t>    Lut;
-    const std::vector<T> & Vals;
-    size_t                 LutEnd;
-};
+    const auto benchmarkMapping = [&]<LutMapping MAPPING>(std::integral_constant<LutMapping, MAPPING>, const std::string &mappingDescr)
+    {
+        using SEARCH = SearchPod32<T, LUT_BITS, PlainLut<size_t>, MAPPING>;
+        const SEARCH sm(vals);
+        BenchmarkAlgo<T>(vals, keys, "Lookup binary search ("+mappingDescr+" LUT mapping)", &SEARCH::LutBinarySearch, sm);
+        BenchmarkAlgo<T>(vals, keys, "Two-level lookup binary search ("+mappingDescr+" LUT mapping)", &SEARCH::LutTwoLevelSearch, sm);
+    };
 
-template<class T, size_t LUT_BITS, class ALGO_FUNC> void BenchmarkAlgo(const std::vector<T> &vals, const std::vector<T> &keys, const std::string &algoName, const ALGO_FUNC &algoFunc, const SearchPod32<T, LUT_BITS> &s)
-{
-    std::cout << "Running: '" << algoName << "':" << std::endl;
-    std::cout << "---------------------------------------" << std::endl;
+    benchmarkMapping(std::integral_constant<LutMapping, LutMapping::CommonPrefix>(), "common prefix");
+    benchmarkMapping(std::integral_constant<LutMapping, LutMapping::Range>(), "range");
+    {
+        const SearchPod32<T, LUT_BITS, PlainLut<uint32_t>> s32(vals);
+        std::cout << "32-bit look-up table footprint: " << s32.MemoryFootprint()/1024 << " KB" << std::endl << std::endl;
+        BenchmarkAlgo<T>(vals, keys, "Lookup binary search (32-bit LUT)", &SearchPod32<T, LUT_BITS, PlainLut<uint32_t>>::LutBinarySearch, s32);
 
-    const auto start = std::chrono::high_resolution_clock::now();
-    size_t res = 0;
+        const SearchPod32<T, LUT_BITS, EliasFanoLut> sef(vals);
+        std::cout << "Elias-Fano look-up table footprint: " << sef.MemoryFootprint()/1024 << " KB" << std::endl << std::endl;
+        BenchmarkAlgo<T>(vals, keys, "Lookup binary search (Elias-Fano LUT)", &SearchPod32<T, LUT_BITS, EliasFanoLut>::LutBinarySearch, sef);
+    }
+    {
+        const DynSearchPod32<T> d(vals);
+        std::cout << "Run-time look-up table size: " << d.NumLutBits() << " (" << d.MemoryFootprint()/1024 << " KB)" << std::endl << std::endl;
+        BenchmarkAlgo<T>(vals, keys, "Run-time sized lookup binary search", &DynSearchPod32<T>::LutBinarySearch, d);
+    }
 
-    for (size_t i=0; i<keys.size(); i++)
+    for (size_t maxError : {16, 64, 256})
     {
-        const auto idx = (s.*algoFunc)(keys[i]);
-        assert(vals[idx] == keys[i]);
-        res += idx; // that loop doesn't get optimized out
+        const RadixSplinePod32<T, std::min<size_t>(LUT_BITS, 16)> r(vals, maxError);
+        std::cout << "RadixSpline footprint: " << r.MemoryFootprint()/1024 << " KB (" << r.NumKnots() << " knots)" << std::endl << std::endl;
+        BenchmarkAlgo<T>(vals, keys, "RadixSpline search (max. error "+std::to_string(maxError)+")", &RadixSplinePod32<T, std::min<size_t>(LUT_BITS, 16)>::Search, r);
     }
 
-    const auto end = std::chrono::high_resolution_clock::now();
-    const auto elapsed = end-start;
-    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-    const auto searchesPerSec = (int)((double)keys.size()/((double)ms/1000.0));
+    std::cout << "=============================================================================" << std::endl << std::endl;
+}
 
-    std::cout << "Result: " << res << std::endl;
-    std::cout << "Elapsed time: " << ms << " ms = " << (float)ms/1000.0f << " secs" << std::endl;
-    std::cout << "Searches/sec: " << searchesPerSec << " = " << (float)searchesPerSec/1000.0f/1000.0f << " m" << std::endl;
-    std::cout << std::endl;
+template<class T, size_t LUT_BITS, class RND_DIST_VALS> void Benchmark64(const std::string &typeDescr, RND_DIST_VALS &distVals)
+{
+    std::vector<T> vals, keys;
+    std::mt19937_64 gen(303);
+    GenerateDataSet<T, 1000000000/2>(typeDescr, vals, keys, gen, distVals); // 64-bit values take 2x the memory of 32-bit values
+
+    const SearchPod64<T, LUT_BITS> s(vals);
+    std::cout << "Look-up table footprint: " << s.MemoryFootprint()/1024 << " KB" << std::endl << std::endl;
+    BenchmarkAlgo<T>(vals, keys, "My binary search", &SearchPod64<T, LUT_BITS>::MyBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Standard binary search", &SearchPod64<T, LUT_BITS>::StdBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Lookup binary search", &SearchPod64<T, LUT_BITS>::LutBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Branchless lookup binary search", &SearchPod64<T, LUT_BITS>::LutBranchlessSearch, s);
+
+    std::cout << "=============================================================================" << std::endl << std::endl;
 }
 
-template<class T, size_t LUT_BITS, class RND_DIST_VALS> void Benchmark(const std::string &typeDescr, RND_DIST_VALS &distVals)
+// benchmarks the search LutSearchPod selects for 8-bit and 16-bit types
+template<class T, size_t LUT_BITS, class RND_DIST_VALS> void BenchmarkNarrow(const std::string &typeDescr, RND_DIST_VALS &distVals)
+{
+    std::vector<T> vals, keys;
+    std::mt19937 gen(303);
+    GenerateDataSet<T, 1000000000>(typeDescr, vals, keys, gen, distVals);
+
+    using SEARCH = LutSearchPod<T, LUT_BITS>;
+    const SEARCH s(vals);
+    std::cout << "Look-up table footprint: " << s.MemoryFootprint()/1024 << " KB";
+    std::cout << (std::is_same_v<SEARCH, DirectSearchPod<T>> ? " (direct address)" : "") << std::endl << std::endl;
+    BenchmarkAlgo<T>(vals, keys, "My binary search", &SEARCH::MyBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Standard binary search", &SEARCH::StdBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Lookup binary search", &SEARCH::LutBinarySearch, s);
+    BenchmarkAlgo<T>(vals, keys, "Branchless lookup binary search", &SEARCH::LutBranchlessSearch, s);
+
+    std::cout << "=============================================================================" << std::endl << std::endl;
+}
+
+template<size_t LUT_BITS> void BenchmarkStrings(const std::string &typeDescr)
 {
-    const size_t NUM_VALS = 1000000000;
+    const size_t NUM_VALS = 1000000000/20; // strings, their views and a SearchString take up to 20x the memory of 32-bit values
     const size_t NUM_KEYS = 10000000;
 
-    std::vector<T> vals(NUM_VALS), keys(NUM_KEYS);
+    std::vector<std::string> vals(NUM_VALS);
+    std::vector<std::string_view> keys(NUM_KEYS);
     std::mt19937 gen(303);
     std::uniform_int_distribution<size_t> distKeys(0, vals.size()-1);
+    std::uniform_int_distribution<int> distChar('a', 'z'), distLen(4, 24);
 
     std::cout << "Benchmarking: " << typeDescr << std::endl;
     std::cout << "Generating data set..." << std::endl;
 
+    // URL-like strings: "https://" is shared by all of them
     for (auto &v : vals)
-        v = distVals(gen);
+    {
+        v = "https://";
+        for (int i=0, len=distLen(gen); i<len; i++)
+            v += (i == len/2 ? '/' : (char)distChar(gen));
+    }
+
+    std::cout << "Pre-sorting data set..." << std::endl << std::endl;
+    std::sort(vals.begin(), vals.end());
+
     for (auto &k : keys)
         k = vals[distKeys(gen)];
 
-    std::cout << "Pre-sorting data set..." << std::endl << std::endl;
-    std::sort(vals.begin(), vals.end()); // sort so that binary search is applicable
+    // BenchmarkAlgo() checks the results against views of the values
+    const std::vector<std::string_view> valViews(vals.begin(), vals.end());
 
-    SearchPod32<T, LUT_BITS> s(vals);
-    BenchmarkAlgo<T>(vals, keys, "My binary search", &SearchPod32<T, LUT_BITS>::MyBinarySearch, s);
-    BenchmarkAlgo<T>(vals, keys, "Standard binary search", &SearchPod32<T, LUT_BITS>::StdBinarySearch, s);
-    BenchmarkAlgo<T>(vals, keys, "Lookup binary search", &SearchPod32<T, LUT_BITS>::LutBinarySearch, s);
+    // each SearchString has a copy of the values, so only keep one alive at a time
+    {
+        const SearchString<LUT_BITS, uint64_t> s8(vals);
+        std::cout << "Look-up table footprint: " << s8.MemoryFootprint()/1024 << " KB (8-byte prefix)" << std::endl << std::endl;
+        BenchmarkAlgo<std::string_view>(valViews, keys, "My binary search", &SearchString<LUT_BITS, uint64_t>::MyBinarySearch, s8);
+        BenchmarkAlgo<std::string_view>(valViews, keys, "Lookup binary search (8-byte prefix)", &SearchString<LUT_BITS, uint64_t>::LutBinarySearch, s8);
+    }
+    {
+        const SearchString<LUT_BITS, uint32_t> s4(vals);
+        std::cout << "Look-up table footprint: " << s4.MemoryFootprint()/1024 << " KB (4-byte prefix)" << std::endl << std::endl;
+        BenchmarkAlgo<std::string_view>(valViews, keys, "Lookup binary search (4-byte prefix)", &SearchString<LUT_BITS, uint32_t>::LutBinarySearch, s4);
+    }
+
+    std::cout << "=============================================================================" << std::endl << std::endl;
+}
+
+template<size_t LUT_BITS, class... TS, class... RND_DISTS> void BenchmarkTuples(const std::string &typeDescr, RND_DISTS &... dists)
+{
+    using Tuple = std::tuple<TS...>;
+    using SEARCH = SearchTuple<LUT_BITS, TS...>;
+    using Prefix = std::tuple<std::tuple_element_t<0, Tuple>>;
+
+    std::vector<Tuple> vals, keys;
+    std::mt19937 gen(303);
+    const auto distTuples = [&](std::mt19937 &g)
+    {
+        return Tuple(dists(g)...);
+    };
+
+    GenerateDataSet<Tuple, 1000000000/4>(typeDescr, vals, keys, gen, distTuples); // tuples + packed copy take about 4x the memory of 32-bit values
+
+    const SEARCH s(vals);
+    std::cout << "Look-up table footprint: " << s.MemoryFootprint()/1024 << " KB (" << SEARCH::PACKED_BITS << "-bit packed keys)" << std::endl << std::endl;
+    BenchmarkAlgo<Tuple>(vals, keys, "Standard binary search", &SEARCH::StdBinarySearch, s);
+    BenchmarkAlgo<Tuple>(vals, keys, "Lookup binary search", &SEARCH::LutBinarySearch, s);
+
+    // all tuples sharing the key's first field
+    BenchmarkQuery(keys, "Standard equal range (first field)", [&](const Tuple &key)
+    {
+        const auto range = std::equal_range(vals.begin(), vals.end(), key, [](const Tuple &a, const Tuple &b)
+        {
+            return KeyLess(std::get<0>(a), std::get<0>(b));
+        });
+
+        assert(range.first < range.second && KeyEqual(std::get<0>(*range.first), std::get<0>(key)));
+        return range.second-range.first;
+    });
+
+    BenchmarkQuery(keys, "Lookup equal range (first field)", [&](const Tuple &key)
+    {
+        const auto range = s.EqualRange(Prefix(std::get<0>(key)));
+        assert(std::get<0>(vals[range.first]) == std::get<0>(key) && (size_t)s.LutBinarySearch(key) < range.second);
+        return range.second-range.first;
+    });
+
+    std::cout << "=============================================================================" << std::endl << std::endl;
+}
+
+// key look-ups which return a 32-byte payload: LutFlatMap vs. binary
+// search over sorted (key, payload) pairs
+template<class K, size_t LUT_BITS, class RND_DIST_VALS> void BenchmarkFlatMap(const std::string &typeDescr, RND_DIST_VALS &distVals)
+{
+    struct Payload
+    {
+        uint64_t Data[4];
+    };
+
+    using Pair = std::pair<K, Payload>;
+
+    std::vector<K> vals, keys;
+    std::mt19937 gen(303);
+    GenerateDataSet<K, 1000000000/16>(typeDescr, vals, keys, gen, distVals); // pairs, map and input take about 16x the memory of 32-bit values
+
+    std::vector<Pair> pairs(vals.size());
+    for (size_t i=0; i<pairs.size(); i++)
+        pairs[i] = Pair(vals[i], Payload{{i, i, i, i}});
+    std::vector<K>().swap(vals); // only the pairs are needed from here on
+
+    std::cout << "Building flat map..." << std::endl << std::endl;
+    const LutFlatMap<K, Payload, LUT_BITS> map(pairs);
+
+    // same pairs as the map, i.e. sorted and without duplicates
+    std::vector<Pair> sortedPairs(map.Size());
+    for (size_t i=0; i<sortedPairs.size(); i++)
+        sortedPairs[i] = Pair(map.Key(i), map.Value(i));
+
+    std::cout << "Look-up table footprint: " << (map.MemoryFootprint()-map.Size()*(sizeof(K)+sizeof(Payload)))/1024 << " KB" << std::endl << std::endl;
+
+    BenchmarkQuery(keys, "Standard search (sorted pairs)", [&](K key)
+    {
+        const auto iter = std::lower_bound(sortedPairs.begin(), sortedPairs.end(), key, [](const Pair &a, K b)
+        {
+            return KeyLess(a.first, b);
+        });
+
+        assert(iter != sortedPairs.end() && KeyEqual(iter->first, key));
+        return iter->second.Data[0];
+    });
+
+    BenchmarkQuery(keys, "Lookup search (flat map)", [&](K key)
+    {
+        const Payload *payload = map.FindValue(key);
+        assert(payload != nullptr && KeyEqual(map.Key(map.Find(key)), key));
+        return payload->Data[0];
+    });
+
+    std::cout << "=============================================================================" << std::endl << std::endl;
+}
+
+template<size_t LUT_BITS> void Benchmark128(const std::string &typeDescr)
+{
+    std::vector<Key128> vals, keys;
+    std::mt19937_64 gen(303);
+    const auto distKey128 = [](std::mt19937_64 &g)
+    {
+        return Key128{g(), g()};
+    };
+
+    GenerateDataSet<Key128, 1000000000/8>(typeDescr, vals, keys, gen, distKey128); // two copies (interleaved and split layout) of 128-bit keys take about 8x the memory of 32-bit values
+
+    const SearchPod128<LUT_BITS> s(vals);
+    std::cout << "Look-up table footprint: " << s.MemoryFootprint()/1024 << " KB" << std::endl << std::endl;
+    BenchmarkAlgo<Key128>(vals, keys, "My binary search", &SearchPod128<LUT_BITS>::MyBinarySearch, s);
+    BenchmarkAlgo<Key128>(vals, keys, "Standard binary search", &SearchPod128<LUT_BITS>::StdBinarySearch, s);
+    BenchmarkAlgo<Key128>(vals, keys, "Lookup binary search", &SearchPod128<LUT_BITS>::LutBinarySearch, s);
+
+    {
+        const SearchPod128<LUT_BITS> ss(vals, Key128Layout::Split);
+        BenchmarkAlgo<Key128>(vals, keys, "Lookup binary search (split layout)", &SearchPod128<LUT_BITS>::LutBinarySearch, ss);
+    }
 
     std::cout << "=============================================================================" << std::endl << std::endl;
 }
@@ -232,6 +4029,35 @@ template<size_t LUT_BITS> void BenchmarkPods()
     Benchmark<uint32_t, LUT_BITS>("Unsigned 32-bit integer", distIntUnsigned);
     Benchmark<int32_t, LUT_BITS>("Signed 32-bit integer", distIntSigned);
     Benchmark<float, LUT_BITS>("32-bit floating point", distFloat);
+
+    std::uniform_int_distribution<uint64_t> distInt64Unsigned(std::numeric_limits<uint64_t>::min(), std::numeric_limits<uint64_t>::max());
+    std::uniform_int_distribution<int64_t> distInt64Signed(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+    std::uniform_real_distribution<double> distDouble(-999.0, 999.0);
+
+    Benchmark64<uint64_t, LUT_BITS>("Unsigned 64-bit integer", distInt64Unsigned);
+    Benchmark64<int64_t, LUT_BITS>("Signed 64-bit integer", distInt64Signed);
+    Benchmark64<double, LUT_BITS>("64-bit floating point", distDouble);
+    Benchmark128<LUT_BITS>("128-bit key");
+    BenchmarkStrings<LUT_BITS>("Strings");
+
+    std::uniform_int_distribution<uint32_t> distTenant(0, 9999);
+    std::uniform_int_distribution<uint16_t> distShard(0, 99);
+    BenchmarkTuples<LUT_BITS, uint32_t, uint32_t>("Tuple (uint32, uint32)", distTenant, distIntUnsigned);
+    BenchmarkTuples<LUT_BITS, uint16_t, uint32_t, float>("Tuple (uint16, uint32, float)", distShard, distIntUnsigned, distFloat);
+    BenchmarkFlatMap<uint32_t, LUT_BITS>("Flat map (uint32 -> 32 bytes)", distIntUnsigned);
+    BenchmarkFlatMap<float, LUT_BITS>("Flat map (float -> 32 bytes)", distFloat);
+
+    // std::uniform_int_distribution doesn't support 8-bit types
+    std::uniform_int_distribution<int32_t> distInt8Unsigned(0, 255);
+    std::uniform_int_distribution<int32_t> distInt8Signed(-128, 127);
+    std::uniform_int_distribution<uint16_t> distInt16Unsigned(std::numeric_limits<uint16_t>::min(), std::numeric_limits<uint16_t>::max());
+    std::uniform_int_distribution<int16_t> distInt16Signed(std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max());
+
+    BenchmarkNarrow<uint8_t, LUT_BITS>("Unsigned 8-bit integer", distInt8Unsigned);
+    BenchmarkNarrow<int8_t, LUT_BITS>("Signed 8-bit integer", distInt8Signed);
+    BenchmarkNarrow<uint16_t, LUT_BITS>("Unsigned 16-bit integer", distInt16Unsigned);
+    BenchmarkNarrow<int16_t, LUT_BITS>("Signed 16-bit integer", distInt16Signed);
+    BenchmarkNarrow<Half, LUT_BITS>("16-bit floating point", distFloat);
 }
 
 int main(int argc, char **argv)